@@ -0,0 +1,302 @@
+// Benchmarks.cpp
+// Microbenchmarks for the geometry core and the polygon manager, as a separate executable.
+
+// Each benchmark runs its body in growing batches until a batch takes at least minTime, and reports the time
+// per operation, the vertices processed per second, and the heap allocations per operation (counted by
+// replacing the global operator new). The results are printed as a table and written to a JSON file.
+//
+// Usage: Benchmarks [--filter <text>] [--sizes <n,n,...>] [--time <seconds>] [--json <file>]
+//		--filter	Only run the benchmarks whose names contain text
+//		--sizes		Scene sizes (number of polygons) for the manager benchmarks; default 1000,10000,100000
+//		--time		Minimum time per benchmark; default 0.25 s
+//		--json		Where to write the results; default benchmarks.json
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include "Derived shapes.h"
+#include "PolygonArena.h"
+#include "PolygonManager.h"
+#include "VertexStore.h"
+
+// Allocation counting
+
+namespace {
+	std::atomic<std::uint64_t> allocations{ 0 };
+}
+
+void* operator new(std::size_t size)
+{
+	allocations++;
+	void* const p{ std::malloc(size != 0 ? size : 1) };
+	if (p == nullptr) { throw std::bad_alloc(); }
+	return p;
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+	typedef std::chrono::steady_clock Clock;
+
+	struct Result {
+		std::string name;
+		std::size_t size; // Polygons in the scene, or vertices in the polygon (0 if neither applies)
+		std::uint64_t iterations; // Operations timed
+		double nsperop, verticespersec, allocsperop;
+	};
+
+	std::vector<Result> results;
+	std::string filter;
+	double minTime{ 0.25 };
+
+	volatile double sink; // Results are written here so the work can't be optimised away
+
+	// Time body(), which does ops operations on vertices vertices each. It's run once first to warm up.
+	template<class Body>
+	void bench(const std::string& name, const std::size_t size, const std::size_t ops, const double vertices,
+		const Body& body)
+	{
+		if (!filter.empty() && name.find(filter) == std::string::npos) { return; }
+		body();
+		std::uint64_t calls{ 1 };
+		while (true) {
+			const std::uint64_t before{ allocations.load() };
+			const Clock::time_point start{ Clock::now() };
+			for (std::uint64_t c{ 0 }; c < calls; c++) { body(); }
+			const double seconds{ std::chrono::duration<double>(Clock::now() - start).count() };
+			const std::uint64_t allocated{ allocations.load() - before };
+			if (seconds >= minTime) {
+				const double total{ (double)calls * ops };
+				const Result result{ name, size, (std::uint64_t)total, 1e9 * seconds / total,
+					vertices * total / seconds, allocated / total };
+				results.push_back(result);
+				std::printf("%-32s %8zu %12llu %14.2f %14.2f %12.3f\n", name.c_str(), size,
+					(unsigned long long)result.iterations, result.nsperop, 1e-6 * result.verticespersec, result.allocsperop);
+				return;
+			}
+			// Aim for 1.2 * minTime next time, but grow by at most 100x at once
+			const double factor{ seconds > 0 ? 1.2 * minTime / seconds : 100 };
+			calls = (std::uint64_t)(calls * (factor < 2 ? 2 : factor > 100 ? 100 : factor));
+		}
+	}
+
+	// A scene of n polygons of assorted types, spread over a square. Returns the number of vertices.
+	const double buildscene(PolygonManager& pm, const std::size_t n)
+	{
+		double vertices{ 0 };
+		std::mt19937 rng(12345);
+		std::uniform_real_distribution<double> position(-100, 100), size(0.5, 2);
+		pm.clear();
+		pm.reserve(n, 8 * n);
+		for (std::size_t i{ 0 }; i < n; i++) {
+			switch (i % 5) {
+			case 0: pm.addisos(size(rng), size(rng)); vertices += 3; break;
+			case 1: pm.addrect(size(rng), size(rng)); vertices += 4; break;
+			case 2: pm.addpenta(size(rng)); vertices += 5; break;
+			case 3: pm.addhexa(size(rng)); vertices += 6; break;
+			default: {
+				const unsigned int sides{ 3 + (unsigned int)(rng() % 14) };
+				pm.addngon(sides, size(rng));
+				vertices += sides;
+				break;
+			}
+			}
+			pm.translate((unsigned int)i + 1, Vector(position(rng), position(rng)));
+		}
+		return vertices;
+	}
+
+	// Benchmarks:
+
+	void vectorbenchmarks()
+	{
+		const std::size_t n{ 1024 };
+		std::vector<Vector> v(n);
+		std::mt19937 rng(1);
+		std::uniform_real_distribution<double> u(-1, 1);
+		for (auto it = v.begin(); it != v.end(); it++) { *it = Vector(u(rng), u(rng)); }
+		const Matrix m(0.8, -0.6, 0.6, 0.8);
+
+		bench("vector.add", 0, n, 0, [&] {
+			Vector sum;
+			for (std::size_t i{ 0 }; i < n; i++) { sum += v[i]; }
+			sink = sum.getx();
+		});
+		bench("vector.dot", 0, n, 0, [&] {
+			double sum{ 0 };
+			for (std::size_t i{ 0 }; i + 1 < n; i++) { sum += v[i].dot(v[i + 1]); }
+			sink = sum;
+		});
+		bench("vector.index", 0, n, 0, [&] { // Default element access (unchecked here, as NDEBUG is defined)
+			double sum{ 0 };
+			for (std::size_t i{ 0 }; i < n; i++) { sum += v[i](1) + v[i](2); }
+			sink = sum;
+		});
+		bench("vector.index.checked", 0, n, 0, [&] { // Range-checked element access, whatever the build
+			double sum{ 0 };
+			for (std::size_t i{ 0 }; i < n; i++) { sum += v[i].at<access::Checked>(1) + v[i].at<access::Checked>(2); }
+			sink = sum;
+		});
+		bench("matrix.vector", 0, n, 0, [&] {
+			Vector sum;
+			for (std::size_t i{ 0 }; i < n; i++) { sum += m * v[i]; }
+			sink = sum.getx();
+		});
+		bench("matrix.matrix", 0, n, 0, [&] {
+			Matrix product(1, 0, 0, 1);
+			for (std::size_t i{ 0 }; i < n; i++) { product = product * m; }
+			sink = product(1, 1);
+		});
+		return;
+	}
+
+	void polygonbenchmarks()
+	{
+		const unsigned int sizes[]{ 8, 64, 1024 };
+		for (const unsigned int n : sizes) {
+			VertexStore store;
+			PolygonArena arena;
+			Polygon* const poly{ fact::createGenPoly(n, 2.0, &store, &arena) };
+
+			bench("polygon.area", n, 1, n, [&] { sink = poly->area(); }); // Cached (see Polygon.h)
+			bench("polygon.centre", n, 1, n, [&] { sink = poly->centre().getx(); });
+			bench("polygon.rotateorigin", n, 1, n, [&] {
+				poly->rotateorigin(0.001);
+				double m[6];
+				poly->getpose().coefficients(m);
+				sink = m[0];
+			});
+			bench("polygon.rotateorigin.materialise", n, 1, n, [&] { // Including working out the world vertices
+				poly->rotateorigin(0.001);
+				sink = poly->x()[0];
+			});
+			bench("genpoly.create", n, 1, n, [&] {
+				Polygon* const created{ fact::createGenPoly(n, 1.0, &store, &arena) };
+				sink = created->size();
+				arena.destroy(created);
+			});
+			arena.destroy(poly);
+		}
+
+		VertexStore store;
+		PolygonArena arena;
+		Polygon* const rect{ fact::createRectangle(2, 1, &store, &arena) };
+		rect->rotateorigin(0.5);
+		bool grow{ true };
+		bench("symmetric.rescale", 4, 1, 4, [&] {
+			rect->rescale(grow ? 1.01 : 1 / 1.01, 1.0);
+			grow = !grow;
+			sink = rect->x()[0];
+		});
+		arena.destroy(rect);
+		return;
+	}
+
+	void managerbenchmarks(const std::vector<std::size_t>& sizes)
+	{
+		std::ostream null(nullptr); // Discards everything written to it
+		for (const std::size_t n : sizes) {
+			PolygonManager pm;
+			const double vertices{ buildscene(pm, n) };
+
+			bench("manager.translateall", n, 1, vertices, [&] { pm.translateall(Vector(0.001, -0.001)); });
+			bench("manager.rotateall", n, 1, vertices, [&] { pm.rotateall(0.001); });
+			bool grow{ true };
+			bench("manager.rescaleall", n, 1, vertices, [&] {
+				pm.rescaleall(grow ? 1.01 : 1 / 1.01, 1.0);
+				grow = !grow;
+			});
+			bench("manager.centreall", n, 1, vertices, [&] { pm.centreall(); });
+			bench("manager.draw", n, 1, vertices, [&] { pm.draw(null); }); // Nothing has changed: reuses the last image
+			bench("manager.rotateall.draw", n, 1, vertices, [&] { // A full redraw, including working out the vertices
+				pm.rotateall(0.001);
+				pm.draw(null);
+			});
+
+			// One step of a scripted animation: a few small transformations to every polygon, with the spatial
+			// index on, applied one at a time or composed in a transaction
+			pm.setindexing(true);
+			const auto step = [&] {
+				for (unsigned int i{ 1 }; i <= (unsigned int)pm.count(); i++) {
+					pm.translate(i, Vector(0.001, 0));
+					pm.rotate(i, 0.001);
+					pm.translate(i, Vector(-0.001, 0));
+					pm.rotate(i, -0.001);
+				}
+			};
+			bench("manager.step", n, 1, vertices, step);
+			bench("manager.step.transaction", n, 1, vertices, [&] {
+				pm.begin();
+				step();
+				pm.commit();
+			});
+			pm.setindexing(false);
+		}
+		return;
+	}
+
+	void writejson(const char* const path)
+	{
+		std::FILE* const out{ std::fopen(path, "w") };
+		if (out == nullptr) {
+			std::cerr << "Error: Could not open " << path << " for writing." << std::endl;
+			return;
+		}
+		std::fprintf(out, "{\n  \"benchmarks\": [\n");
+		for (std::size_t i{ 0 }; i < results.size(); i++) {
+			const Result& r{ results[i] };
+			std::fprintf(out, "    { \"name\": \"%s\", \"size\": %zu, \"iterations\": %llu, \"ns_per_op\": %.3f, "
+				"\"vertices_per_s\": %.1f, \"allocs_per_op\": %.4f }%s\n", r.name.c_str(), r.size,
+				(unsigned long long)r.iterations, r.nsperop, r.verticespersec, r.allocsperop,
+				i + 1 < results.size() ? "," : "");
+		}
+		std::fprintf(out, "  ]\n}\n");
+		std::fclose(out);
+		return;
+	}
+
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<std::size_t> sizes{ 1000, 10000, 100000 };
+	const char* json{ "benchmarks.json" };
+	for (int i{ 1 }; i < argc; i++) {
+		const bool hasvalue{ i + 1 < argc };
+		if (std::strcmp(argv[i], "--filter") == 0 && hasvalue) { filter = argv[++i]; }
+		else if (std::strcmp(argv[i], "--time") == 0 && hasvalue) { minTime = std::atof(argv[++i]); }
+		else if (std::strcmp(argv[i], "--json") == 0 && hasvalue) { json = argv[++i]; }
+		else if (std::strcmp(argv[i], "--sizes") == 0 && hasvalue) {
+			sizes.clear();
+			char* p{ argv[++i] };
+			while (*p != '\0') {
+				sizes.push_back(std::strtoul(p, &p, 10));
+				if (*p != ',') { break; }
+				p++;
+			}
+		}
+		else {
+			std::cerr << "Usage: " << argv[0] << " [--filter <text>] [--sizes <n,n,...>] [--time <seconds>] [--json <file>]" << std::endl;
+			return 1;
+		}
+	}
+
+	std::printf("%-32s %8s %12s %14s %14s %12s\n", "benchmark", "size", "ops", "ns/op", "Mvertices/s", "allocs/op");
+	vectorbenchmarks();
+	polygonbenchmarks();
+	managerbenchmarks(sizes);
+	writejson(json);
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,263 @@
+// AABBTree.cpp
+// A dynamic bounding volume hierarchy of axis-aligned boxes.
+
+// Insertion follows the usual approach for dynamic AABB trees (as in e.g. Box2D): walk down from the root,
+// at each level going to whichever child would grow least by taking in the new box, and then pair the new leaf
+// with the node reached. The bulk build splits the leaves at the median along the longer axis of their
+// bounding box, which gives a balanced tree.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "AABBTree.h"
+
+const double AABBTree::margin{ 0.1 };
+
+const Box AABBTree::fatten(const Box& box)
+{
+	const double d{ margin * std::fmax(box.width(), box.height()) + 1e-9 };
+	return Box(box.min - Vector(d, d), box.max + Vector(d, d));
+}
+
+const double AABBTree::perimeter(const Box& box)
+{
+	return 2 * (box.width() + box.height());
+}
+
+// Node allocation, reusing released nodes where possible
+
+int AABBTree::allocate()
+{
+	if (freelist != -1) {
+		const int node{ freelist };
+		freelist = nodes[node].parent;
+		nodes[node] = Node{ Box(), -1, -1, -1, 0 };
+		return node;
+	}
+	nodes.push_back(Node{ Box(), -1, -1, -1, 0 });
+	return (int)nodes.size() - 1;
+}
+
+void AABBTree::release(const int node)
+{
+	nodes[node].parent = freelist;
+	nodes[node].left = nodes[node].right = -2; // Neither a leaf nor a branch
+	freelist = node;
+}
+
+void AABBTree::refit(int node)
+{
+	while (node != -1) {
+		const Node& n{ nodes[node] };
+		nodes[node].box = nodes[n.left].box.merge(nodes[n.right].box);
+		node = n.parent;
+	}
+}
+
+// Leaf insertion and removal
+
+void AABBTree::insertleaf(const int leaf)
+{
+	if (root == -1) {
+		root = leaf;
+		nodes[leaf].parent = -1;
+		return;
+	}
+
+	// Find the best sibling
+	const Box& box{ nodes[leaf].box };
+	int node{ root };
+	while (!nodes[node].isleaf()) {
+		const Node& n{ nodes[node] };
+		const double grow{ perimeter(n.box.merge(box)) };
+		const double inherited{ grow - perimeter(n.box) }; // Extra cost pushed onto everything below this node
+		const double costhere{ 2 * grow }; // Cost of making a new parent here
+		const double costleft{ perimeter(nodes[n.left].box.merge(box))
+			- (nodes[n.left].isleaf() ? 0 : perimeter(nodes[n.left].box)) + inherited };
+		const double costright{ perimeter(nodes[n.right].box.merge(box))
+			- (nodes[n.right].isleaf() ? 0 : perimeter(nodes[n.right].box)) + inherited };
+		if (costhere < costleft && costhere < costright) { break; }
+		node = (costleft < costright) ? n.left : n.right;
+	}
+
+	// Make a new parent for the sibling and the leaf
+	const int sibling{ node };
+	const int oldparent{ nodes[sibling].parent };
+	const int parent{ allocate() };
+	nodes[parent].parent = oldparent;
+	nodes[parent].left = sibling;
+	nodes[parent].right = leaf;
+	nodes[sibling].parent = parent;
+	nodes[leaf].parent = parent;
+	if (oldparent == -1) { root = parent; }
+	else if (nodes[oldparent].left == sibling) { nodes[oldparent].left = parent; }
+	else { nodes[oldparent].right = parent; }
+	refit(parent);
+}
+
+void AABBTree::removeleaf(const int leaf)
+{
+	if (leaf == root) {
+		root = -1;
+		return;
+	}
+	const int parent{ nodes[leaf].parent };
+	const int grandparent{ nodes[parent].parent };
+	const int sibling{ (nodes[parent].left == leaf) ? nodes[parent].right : nodes[parent].left };
+	nodes[sibling].parent = grandparent;
+	if (grandparent == -1) { root = sibling; }
+	else {
+		if (nodes[grandparent].left == parent) { nodes[grandparent].left = sibling; }
+		else { nodes[grandparent].right = sibling; }
+		refit(grandparent);
+	}
+	release(parent);
+}
+
+// Public functions
+
+const int AABBTree::insert(const Box& box, const unsigned int key)
+{
+	const int leaf{ allocate() };
+	nodes[leaf].box = fatten(box);
+	nodes[leaf].key = key;
+	insertleaf(leaf);
+	return leaf;
+}
+
+void AABBTree::remove(const int proxy)
+{
+	removeleaf(proxy);
+	release(proxy);
+}
+
+// Only reinsert if the new box has moved outside the enlarged one
+void AABBTree::update(const int proxy, const Box& box)
+{
+	const Box& fat{ nodes[proxy].box };
+	if (fat.contains(box.min) && fat.contains(box.max)) { return; }
+	removeleaf(proxy);
+	nodes[proxy].box = fatten(box);
+	insertleaf(proxy);
+}
+
+void AABBTree::shift(const Vector& r)
+{
+	for (auto it = nodes.begin(); it != nodes.end(); it++) {
+		it->box = Box(it->box.min + r, it->box.max + r);
+	}
+}
+
+void AABBTree::clear()
+{
+	nodes.clear();
+	root = -1;
+	freelist = -1;
+}
+
+// Bulk build: create all the leaves, then split them recursively
+void AABBTree::build(const std::vector<Box>& boxes, std::vector<int>& proxies)
+{
+	clear();
+	proxies.resize(boxes.size());
+	if (boxes.empty()) { return; }
+	nodes.reserve(2 * boxes.size());
+	for (std::size_t i{ 0 }; i < boxes.size(); i++) {
+		proxies[i] = allocate();
+		nodes[proxies[i]].box = fatten(boxes[i]);
+		nodes[proxies[i]].key = (unsigned int)i;
+	}
+	std::vector<int> leaves(proxies);
+	root = buildrange(leaves.data(), (int)leaves.size());
+	nodes[root].parent = -1;
+}
+
+int AABBTree::buildrange(int* leaves, const int count)
+{
+	if (count == 1) { return leaves[0]; }
+
+	Box bounds{ nodes[leaves[0]].box };
+	for (int i{ 1 }; i < count; i++) { bounds = bounds.merge(nodes[leaves[i]].box); }
+	const bool alongx{ bounds.width() >= bounds.height() };
+	const auto centre = [&](const int leaf) {
+		const Box& b{ nodes[leaf].box };
+		return alongx ? b.min.getx() + b.max.getx() : b.min.gety() + b.max.gety();
+	};
+	const int half{ count / 2 };
+	std::nth_element(leaves, leaves + half, leaves + count, [&](const int a, const int b) { return centre(a) < centre(b); });
+
+	const int left{ buildrange(leaves, half) };
+	const int right{ buildrange(leaves + half, count - half) };
+	const int node{ allocate() };
+	nodes[node].left = left;
+	nodes[node].right = right;
+	nodes[node].box = bounds;
+	nodes[left].parent = node;
+	nodes[right].parent = node;
+	return node;
+}
+
+void AABBTree::query(const Box& region, std::vector<unsigned int>& keys) const
+{
+	if (root == -1) { return; }
+	std::vector<int> stack;
+	stack.reserve(64); // Enough for most trees, so the stack doesn't keep reallocating as it grows
+	query(region, keys, stack);
+	return;
+}
+
+void AABBTree::query(const Box& region, std::vector<unsigned int>& keys, std::vector<int>& stack) const
+{
+	if (root == -1) { return; }
+	stack.clear();
+	stack.push_back(root);
+	while (!stack.empty()) {
+		const Node& n{ nodes[stack.back()] };
+		stack.pop_back();
+		if (!n.box.overlaps(region)) { continue; }
+		if (n.isleaf()) { keys.push_back(n.key); }
+		else {
+			stack.push_back(n.left);
+			stack.push_back(n.right);
+		}
+	}
+}
+
+// Slab test against each box: the ray is origin + t*direction for t >= 0
+void AABBTree::raycast(const Vector& origin, const Vector& direction, std::vector<unsigned int>& keys) const
+{
+	if (root == -1) { return; }
+	const double inf{ std::numeric_limits<double>::infinity() };
+	const double o[2]{ origin.getx(), origin.gety() };
+	const double d[2]{ direction.getx(), direction.gety() };
+	const auto hit = [&](const Box& box) {
+		const double lo[2]{ box.min.getx(), box.min.gety() }, hi[2]{ box.max.getx(), box.max.gety() };
+		double tmin{ 0 }, tmax{ inf };
+		for (int k{ 0 }; k < 2; k++) {
+			if (d[k] == 0) {
+				if (o[k] < lo[k] || o[k] > hi[k]) { return false; }
+				continue;
+			}
+			double t1{ (lo[k] - o[k]) / d[k] }, t2{ (hi[k] - o[k]) / d[k] };
+			if (t1 > t2) { std::swap(t1, t2); }
+			tmin = std::fmax(tmin, t1);
+			tmax = std::fmin(tmax, t2);
+			if (tmin > tmax) { return false; }
+		}
+		return true;
+	};
+
+	std::vector<int> stack;
+	stack.reserve(64); // Enough for most trees, so the stack doesn't keep reallocating as it grows
+	stack.push_back(root);
+	while (!stack.empty()) {
+		const Node& n{ nodes[stack.back()] };
+		stack.pop_back();
+		if (!hit(n.box)) { continue; }
+		if (n.isleaf()) { keys.push_back(n.key); }
+		else {
+			stack.push_back(n.left);
+			stack.push_back(n.right);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+// AABBTree.h
+// A dynamic bounding volume hierarchy of axis-aligned boxes, used as a spatial index over polygons.
+// Each leaf holds a (slightly enlarged) bounding box and an integer key identifying what it belongs to.
+// Leaves can be inserted, removed and refitted one at a time, or the whole tree can be rebuilt in one go.
+#pragma once
+
+#include <vector>
+#include "Box.h"
+
+class AABBTree {
+private:
+	struct Node {
+		Box box;
+		int parent;
+		int left, right; // Children; left = -1 for a leaf
+		unsigned int key; // Only used by leaves
+		const bool isleaf() const { return left == -1; }
+	};
+
+	std::vector<Node> nodes;
+	int root;
+	int freelist; // Unused nodes, linked through Node::parent
+
+	static const double margin; // Leaf boxes are enlarged by this fraction of their size, so small moves don't need a refit
+
+	int allocate();
+	void release(const int node);
+	void insertleaf(const int leaf);
+	void removeleaf(const int leaf);
+	void refit(int node); // Recompute the boxes from node up to the root
+	int buildrange(int* leaves, const int count); // Top-down build over a set of leaves; returns the subtree root
+
+	static const Box fatten(const Box& box);
+	static const double perimeter(const Box& box); // Cost measure for choosing where to insert
+
+public:
+	AABBTree() : root(-1), freelist(-1) {}
+	~AABBTree() {}
+
+	const int insert(const Box& box, const unsigned int key); // Returns a proxy id for the new leaf
+	void remove(const int proxy);
+	void update(const int proxy, const Box& box); // Refit a leaf to a new box
+	void setkey(const int proxy, const unsigned int key) { nodes[proxy].key = key; }
+	const unsigned int key(const int proxy) const { return nodes[proxy].key; }
+
+	void shift(const Vector& r); // Translate every box in the tree
+	void clear();
+
+	// Rebuild from scratch, with one leaf per box; the key of each leaf is its index in boxes.
+	// The proxy id of each leaf is written to proxies.
+	void build(const std::vector<Box>& boxes, std::vector<int>& proxies);
+
+	// Queries: append the keys of all leaves whose boxes overlap the region / are hit by the ray
+	void query(const Box& region, std::vector<unsigned int>& keys) const;
+	void raycast(const Vector& origin, const Vector& direction, std::vector<unsigned int>& keys) const;
+
+	// query(), but traversing with the caller's stack, so that many queries in a row (e.g. one per point)
+	// don't each allocate their own. The stack's contents on entry don't matter.
+	void query(const Box& region, std::vector<unsigned int>& keys, std::vector<int>& stack) const;
+};
\ No newline at end of file
@@ -0,0 +1,20 @@
+// Access.h
+// Range-checking policies for the element accessors of Vector, Matrix, Affine and Polygon.
+// Checked accessors report an out-of-range index and exit; unchecked ones go straight to the element, so they
+// cost nothing once inlined. The default is checked in debug builds and unchecked in release builds (NDEBUG).
+// Code that has already made sure its indices are in range (e.g. a loop over 0,...,size()-1) can ask for
+// Unchecked explicitly, e.g. poly.vertex<access::Unchecked>(i).
+#pragma once
+
+namespace access {
+
+	struct Checked { static constexpr bool checked{ true }; };
+	struct Unchecked { static constexpr bool checked{ false }; };
+
+#ifdef NDEBUG
+	typedef Unchecked Default;
+#else
+	typedef Checked Default;
+#endif
+
+}
\ No newline at end of file
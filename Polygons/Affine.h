@@ -0,0 +1,99 @@
+// Affine.h
+// A class for 2D affine transformations, v' = Lv + t: a linear part L (rotation, rescaling) followed by a
+// translation t. Used to accumulate the transformations applied to a polygon without touching its vertices.
+// Equivalent to the 3x3 homogeneous matrix
+//		L11	L12	t1
+//		L21	L22	t2
+//		0	0	1
+// Like Vector and Matrix, this is header-only, constexpr where possible and trivially copyable.
+#pragma once
+
+#include <cmath>
+#include <iostream>
+#include <cstdlib>
+#include <type_traits>
+#include "Vector.h"
+#include "Matrix.h"
+
+class Affine {
+private:
+	Matrix L; // linear part
+	Vector t; // translation
+
+	static void singular()
+	{
+		std::cerr << "Error: Attempted to invert a singular transformation." << std::endl;
+		exit(1);
+	}
+
+	[[noreturn]] static void outofrange()
+	{
+		std::cerr << "Error: Attempted to access transformation element out of range." << std::endl;
+		exit(1);
+	}
+
+	// Inverse given the inverse of the linear part: v = L^(-1) (v' - t)
+	constexpr const Affine inverse(const Matrix& Linv) const { return Affine(Linv, -(Linv * t)); }
+
+public:
+	constexpr Affine() : // default ctor - the identity transformation
+		L(1, 0, 0, 1),
+		t(0, 0)
+	{}
+	constexpr Affine(const Matrix& L, const Vector& t) :
+		L(L),
+		t(t)
+	{}
+
+	// Named constructors for the basic transformations
+	static constexpr const Affine translation(const Vector& r) { return Affine(Matrix(1, 0, 0, 1), r); }
+	static const Affine rotation(const double angle) // About the origin
+	{
+		const double c{ std::cos(angle) }, s{ std::sin(angle) };
+		return Affine(Matrix(c, -s, s, c), Vector(0, 0));
+	}
+	static constexpr const Affine scaling(const double x, const double y) // Along the coordinate axes
+	{
+		return Affine(Matrix(x, 0, 0, y), Vector(0, 0));
+	}
+
+	constexpr const Matrix& linear() const { return L; }
+	constexpr const Vector& shift() const { return t; }
+
+	// Element of the homogeneous 3x3 matrix - 1-based, i.e. i, j = 1, 2 or 3. Range checked according to Policy
+	// (see Access.h); the bottom row is always (0 0 1).
+	template<class Policy = access::Default>
+	constexpr const double at(const int i, const int j) const
+	{
+		if constexpr (Policy::checked) { if (i < 1 || i > 3 || j < 1 || j > 3) { outofrange(); } }
+		if (i == 3) { return (j == 3) ? 1.0 : 0.0; }
+		return (j == 3) ? t.at<access::Unchecked>(i) : L.at<access::Unchecked>(i, j);
+	}
+	constexpr const double operator() (const int i, const int j) const { return at(i, j); }
+
+	// Composition: (A * B)v = A(Bv), i.e. B is applied first.
+	// A(Bv) = L_A (L_B v + t_B) + t_A = (L_A L_B) v + (L_A t_B + t_A)
+	constexpr const Affine operator* (const Affine& rhs) const { return Affine(L * rhs.L, L * rhs.t + t); }
+	constexpr const Vector operator() (const Vector& v) const { return L * v + t; } // Apply to a position vector
+
+	constexpr const double det() const { return L.det(); } // Area scale factor (negative if there's a reflection)
+	constexpr const Affine inverse() const
+	{
+		return (det() == 0) ? (singular(), Affine()) :
+			inverse((1.0 / det()) * Matrix(L(2, 2), -L(1, 2), -L(2, 1), L(1, 1)));
+	}
+
+	constexpr const bool isidentity() const
+	{
+		return L(1, 1) == 1 && L(1, 2) == 0 && L(2, 1) == 0 && L(2, 2) == 1 && t.getx() == 0 && t.gety() == 0;
+	}
+
+	void coefficients(double m[6]) const // Row-major 2x3 form (a b tx; c d ty), as used by kernel::transform
+	{
+		m[0] = L(1, 1); m[1] = L(1, 2); m[2] = t.getx();
+		m[3] = L(2, 1); m[4] = L(2, 2); m[5] = t.gety();
+	}
+};
+
+typedef Affine Affine2;
+static_assert(std::is_trivially_copyable<Affine>::value, "Affine must stay trivially copyable");
\ No newline at end of file
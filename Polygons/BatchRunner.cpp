@@ -0,0 +1,456 @@
+// BatchRunner.cpp
+// Headless alternative to InputHandler: runs a script of commands, one per line.
+
+// The script is read in large blocks, and each complete line is tokenised in place - tokens are just
+// pointers into the block, and numbers are read straight from it with strtod/strtoul. Commands are picked by
+// switching on a hash of their name (worked out at compile time for the case labels), then checking the
+// name itself in case of a collision. Nothing is allocated per line, and errors are returned as a Status
+// rather than thrown.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "BatchRunner.h"
+#include "Trace.h"
+#include "UnitCircle.h"
+
+namespace {
+	// FNV-1a hash
+	constexpr std::uint32_t fnv1a(const char* s, const std::uint32_t h = 2166136261u)
+	{
+		return (*s == '\0') ? h : fnv1a(s + 1, (h ^ (std::uint32_t)(unsigned char)*s) * 16777619u);
+	}
+
+	std::uint32_t fnv1a(const char* s, const std::size_t length)
+	{
+		std::uint32_t h{ 2166136261u };
+		for (std::size_t i{ 0 }; i < length; i++) { h = (h ^ (std::uint32_t)(unsigned char)s[i]) * 16777619u; }
+		return h;
+	}
+
+	inline bool isspace(const char c) { return c == ' ' || c == '\t' || c == '\r'; }
+}
+
+BatchRunner::BatchRunner(PolygonManager* pm) :
+	handle(pm),
+	buffer(new char[bufferSize + 1]), // + 1 for a terminator after the last line
+	lineno(0),
+	errors(0)
+{}
+
+const std::size_t BatchRunner::run(const char* const path)
+{
+	if (std::strcmp(path, "-") == 0) { return run(stdin); }
+	std::FILE* const in{ std::fopen(path, "rb") };
+	if (in == nullptr) {
+		std::cerr << "Error: Could not open " << path << "." << std::endl;
+		return 1;
+	}
+	const std::size_t result{ run(in) };
+	std::fclose(in);
+	return result;
+}
+
+// Fill the buffer, run every complete line in it, then move the incomplete last line to the front and read
+// some more. A line that doesn't fit in the buffer at all is reported and skipped.
+const std::size_t BatchRunner::run(std::FILE* const in)
+{
+	lineno = 0;
+	errors = 0;
+	std::size_t filled{ 0 };
+	bool eof{ false }, skipping{ false };
+	while (true) {
+		if (!eof) {
+			const std::size_t got{ std::fread(buffer.get() + filled, 1, bufferSize - filled, in) };
+			filled += got;
+			eof = (got == 0);
+		}
+
+		char* begin{ buffer.get() };
+		char* const end{ buffer.get() + filled };
+		while (char* const newline = static_cast<char*>(std::memchr(begin, '\n', end - begin))) {
+			*newline = '\0';
+			if (skipping) { skipping = false; } // Tail end of a line that was too long
+			else {
+				lineno++;
+				const Status status{ execute(begin) };
+				if (status == stop) { return endrun(); }
+				report(status);
+			}
+			begin = newline + 1;
+		}
+
+		const std::size_t left{ (std::size_t)(end - begin) };
+		if (eof) {
+			if (left > 0 && !skipping) { // Last line, with no newline after it
+				*end = '\0';
+				lineno++;
+				report(execute(begin));
+			}
+			return endrun();
+		}
+		if (left == bufferSize) {
+			if (!skipping) {
+				lineno++;
+				report(linetoolong);
+			}
+			skipping = true;
+			filled = 0;
+			continue;
+		}
+		std::memmove(buffer.get(), begin, left);
+		filled = left;
+	}
+}
+
+const std::size_t BatchRunner::endrun()
+{
+	if (handle->intransaction()) {
+		report(unmatched);
+		handle->commit();
+	}
+	return errors;
+}
+
+void BatchRunner::report(const Status status)
+{
+	if (status == ok || status == stop) { return; }
+	errors++;
+	std::cerr << "Error on line " << lineno << ": " << message(status) << std::endl;
+	return;
+}
+
+const char* BatchRunner::message(const Status status)
+{
+	switch (status) {
+	case ok: return "OK.";
+	case stop: return "Stopped.";
+	case unknowncommand: return "Unknown command.";
+	case badarguments: return "Invalid arguments.";
+	case outofrange: return "No polygon with that number.";
+	case linetoolong: return "Line too long.";
+	case filefailed: return "File operation failed.";
+	case unmatched: return "Unmatched begin or commit.";
+	}
+	return "Unknown error.";
+}
+
+// Tokenise the line, then dispatch on the command name
+const BatchRunner::Status BatchRunner::execute(char* const line)
+{
+	Token t[maxTokens];
+	std::size_t n{ 0 };
+	const char* p{ line };
+	while (true) {
+		while (isspace(*p)) { p++; }
+		if (*p == '\0') { break; }
+		if (n == maxTokens) { return badarguments; }
+		t[n].text = p;
+		while (*p != '\0' && !isspace(*p)) { p++; }
+		t[n].length = p - t[n].text;
+		n++;
+	}
+	if (n == 0 || t[0].text[0] == '#') { return ok; }
+	const trace::Span span("command", t[0].text, t[0].length);
+
+	const auto is = [&](const char* name) { return matches(t[0], name); };
+	switch (fnv1a(t[0].text, t[0].length)) {
+	case fnv1a("add"): if (is("add")) { return addcommand(t, n); } break;
+	case fnv1a("remove"): if (is("remove")) { return removecommand(t, n); } break;
+	case fnv1a("move"): if (is("move")) { return movecommand(t, n); } break;
+	case fnv1a("rotate"): if (is("rotate")) { return rotcommand(t, n); } break;
+	case fnv1a("rescale"): if (is("rescale")) { return rescalecommand(t, n); } break;
+	case fnv1a("area"): if (is("area")) { return areacommand(t, n); } break;
+	case fnv1a("list"): if (is("list")) { return listcommand(t, n); } break;
+	case fnv1a("index"): if (is("index")) { return indexcommand(t, n); } break;
+	case fnv1a("threads"): if (is("threads")) { return threadscommand(t, n); } break;
+	case fnv1a("save"): if (is("save")) { return filecommand(t, n); } break;
+	case fnv1a("load"): if (is("load")) { return filecommand(t, n); } break;
+	case fnv1a("import"): if (is("import")) { return textcommand(t, n); } break;
+	case fnv1a("export"): if (is("export")) { return textcommand(t, n); } break;
+	case fnv1a("centre"):
+		if (is("centre")) {
+			if (n != 1) { return badarguments; }
+			handle->centreall();
+			return ok;
+		}
+		break;
+	case fnv1a("draw"): if (is("draw")) { return drawcommand(t, n); } break;
+	case fnv1a("render"): if (is("render")) { return rendercommand(t, n); } break;
+	case fnv1a("stats"): if (is("stats")) { return statscommand(t, n); } break;
+	case fnv1a("compact"):
+		if (is("compact")) {
+			if (n != 1) { return badarguments; }
+			handle->compact();
+			return ok;
+		}
+		break;
+	case fnv1a("clear"):
+		if (is("clear")) {
+			if (n != 1) { return badarguments; }
+			handle->clear();
+			return ok;
+		}
+		break;
+	case fnv1a("begin"):
+		if (is("begin")) {
+			if (n != 1) { return badarguments; }
+			return handle->begin() ? ok : unmatched;
+		}
+		break;
+	case fnv1a("commit"):
+		if (is("commit")) {
+			if (n != 1) { return badarguments; }
+			return handle->commit() ? ok : unmatched;
+		}
+		break;
+	case fnv1a("finish"): if (is("finish")) { return stop; } break;
+	}
+	return unknowncommand;
+}
+
+// Argument parsing
+
+const bool BatchRunner::matches(const Token& t, const char* const word)
+{
+	return std::strlen(word) == t.length && std::memcmp(t.text, word, t.length) == 0;
+}
+
+const bool BatchRunner::readdouble(const Token& t, double& value) const
+{
+	char* end;
+	value = std::strtod(t.text, &end); // Stops at the whitespace or terminator after the token
+	return end == t.text + t.length && std::isfinite(value);
+}
+
+const bool BatchRunner::readuint(const Token& t, unsigned int& value) const
+{
+	if (t.text[0] < '0' || t.text[0] > '9') { return false; } // strtoul would accept a sign
+	char* end;
+	const unsigned long v{ std::strtoul(t.text, &end, 10) };
+	value = (unsigned int)v;
+	return end == t.text + t.length && v == value;
+}
+
+const bool BatchRunner::readpolygon(const Token& t, unsigned int& i) const
+{
+	return readuint(t, i) && i >= 1 && i <= (unsigned int)handle->count();
+}
+
+// Commands
+
+// add isos|rect <width> <height>, add penta|hexa <R>, add ngon <n> <R>
+const BatchRunner::Status BatchRunner::addcommand(const Token* t, const std::size_t n)
+{
+	if (n < 3) { return badarguments; }
+	const auto is = [&](const char* name) { return matches(t[1], name); };
+	double a, b;
+	unsigned int sides;
+	switch (fnv1a(t[1].text, t[1].length)) {
+	case fnv1a("isos"):
+		if (!is("isos") || n != 4 || !readdouble(t[2], a) || !readdouble(t[3], b) || a <= 0 || b <= 0) { break; }
+		handle->addisos(a, b);
+		return ok;
+	case fnv1a("rect"):
+		if (!is("rect") || n != 4 || !readdouble(t[2], a) || !readdouble(t[3], b) || a <= 0 || b <= 0) { break; }
+		handle->addrect(a, b);
+		return ok;
+	case fnv1a("penta"):
+		if (!is("penta") || n != 3 || !readdouble(t[2], a) || a <= 0) { break; }
+		handle->addpenta(a);
+		return ok;
+	case fnv1a("hexa"):
+		if (!is("hexa") || n != 3 || !readdouble(t[2], a) || a <= 0) { break; }
+		handle->addhexa(a);
+		return ok;
+	case fnv1a("ngon"):
+		if (!is("ngon") || n != 4 || !readuint(t[2], sides) || !readdouble(t[3], a) || sides < 3 || a <= 0) { break; }
+		handle->addngon(sides, a);
+		return ok;
+	}
+	return badarguments;
+}
+
+// remove <i>
+const BatchRunner::Status BatchRunner::removecommand(const Token* t, const std::size_t n)
+{
+	unsigned int i;
+	if (n != 2 || !readuint(t[1], i)) { return badarguments; }
+	if (!readpolygon(t[1], i)) { return outofrange; }
+	handle->remove(i);
+	return ok;
+}
+
+// move <i>|all <x> <y>
+const BatchRunner::Status BatchRunner::movecommand(const Token* t, const std::size_t n)
+{
+	double x, y;
+	if (n != 4 || !readdouble(t[2], x) || !readdouble(t[3], y)) { return badarguments; }
+	if (matches(t[1], "all")) {
+		handle->translateall(Vector(x, y));
+		return ok;
+	}
+	unsigned int i;
+	if (!readuint(t[1], i)) { return badarguments; }
+	if (!readpolygon(t[1], i)) { return outofrange; }
+	handle->translate(i, Vector(x, y));
+	return ok;
+}
+
+// rotate <i>|all <degrees>
+const BatchRunner::Status BatchRunner::rotcommand(const Token* t, const std::size_t n)
+{
+	double angledeg;
+	if (n != 3 || !readdouble(t[2], angledeg)) { return badarguments; }
+	const double angle{ angledeg * 2 * circle::pi / 360 };
+	if (matches(t[1], "all")) {
+		handle->rotateall(angle);
+		return ok;
+	}
+	unsigned int i;
+	if (!readuint(t[1], i)) { return badarguments; }
+	if (!readpolygon(t[1], i)) { return outofrange; }
+	handle->rotate(i, angle);
+	return ok;
+}
+
+// rescale <i>|all <x> <y>
+const BatchRunner::Status BatchRunner::rescalecommand(const Token* t, const std::size_t n)
+{
+	double x, y;
+	if (n != 4 || !readdouble(t[2], x) || !readdouble(t[3], y)) { return badarguments; }
+	if (matches(t[1], "all")) {
+		handle->rescaleall(x, y);
+		return ok;
+	}
+	unsigned int i;
+	if (!readuint(t[1], i)) { return badarguments; }
+	if (!readpolygon(t[1], i)) { return outofrange; }
+	handle->rescale(i, x, y);
+	return ok;
+}
+
+// area <i>
+const BatchRunner::Status BatchRunner::areacommand(const Token* t, const std::size_t n)
+{
+	unsigned int i;
+	if (n != 2 || !readuint(t[1], i)) { return badarguments; }
+	if (!readpolygon(t[1], i)) { return outofrange; }
+	std::cout << "Area of the " << handle->getname(i) << " is " << handle->getarea(i) << "." << std::endl;
+	return ok;
+}
+
+// list: names only; list info: names and vertices
+const BatchRunner::Status BatchRunner::listcommand(const Token* t, const std::size_t n)
+{
+	if (n == 1) {
+		handle->listshapes();
+		return ok;
+	}
+	if (n == 2 && matches(t[1], "info")) {
+		handle->listinfo();
+		return ok;
+	}
+	return badarguments;
+}
+
+// index on|off
+const BatchRunner::Status BatchRunner::indexcommand(const Token* t, const std::size_t n)
+{
+	if (n != 2) { return badarguments; }
+	if (matches(t[1], "on")) { handle->setindexing(true); }
+	else if (matches(t[1], "off")) { handle->setindexing(false); }
+	else { return badarguments; }
+	return ok;
+}
+
+// threads <n>, with 0 for one per hardware thread. More than a few per hardware thread would only add
+// overhead (and a huge n would try to start that many threads), so n may be at most maxThreadsPerCore times
+// the number of hardware threads.
+const BatchRunner::Status BatchRunner::threadscommand(const Token* t, const std::size_t n)
+{
+	const unsigned int maxThreadsPerCore{ 4 };
+	const unsigned int cores{ std::thread::hardware_concurrency() }; // 0 if unknown
+	unsigned int threads;
+	if (n != 2 || !readuint(t[1], threads)) { return badarguments; }
+	if (threads > maxThreadsPerCore * (cores == 0 ? 1 : cores)) { return badarguments; }
+	handle->setthreads(threads);
+	return ok;
+}
+
+// draw [width [height]]. The size is kept for later draws; a height of 0 means half the width. Neither may be
+// more than maxDrawSize.
+const BatchRunner::Status BatchRunner::drawcommand(const Token* t, const std::size_t n)
+{
+	unsigned int width, height;
+	if (n > 3 || (n > 1 && !readuint(t[1], width)) || (n > 2 && !readuint(t[2], height))) { return badarguments; }
+	if ((n > 1 && width > PolygonManager::maxDrawSize) || (n > 2 && height > PolygonManager::maxDrawSize)) {
+		return badarguments;
+	}
+	if (n > 1) { handle->setdrawWidth(width); }
+	if (n > 2) { handle->setdrawHeight(height); }
+	handle->draw();
+	return ok;
+}
+
+// render pbm|pgm evenodd|nonzero <width> <height> <file>, with width and height at most maxImageSize
+const BatchRunner::Status BatchRunner::rendercommand(const Token* t, const std::size_t n)
+{
+	if (n != 6) { return badarguments; }
+	PolygonManager::ImageFormat format;
+	if (matches(t[1], "pbm")) { format = PolygonManager::pbm; }
+	else if (matches(t[1], "pgm")) { format = PolygonManager::pgm; }
+	else { return badarguments; }
+	PolygonManager::FillRule rule;
+	if (matches(t[2], "evenodd")) { rule = PolygonManager::evenodd; }
+	else if (matches(t[2], "nonzero")) { rule = PolygonManager::nonzero; }
+	else { return badarguments; }
+	unsigned int width, height;
+	if (!readuint(t[3], width) || !readuint(t[4], height)) { return badarguments; }
+	if (width > PolygonManager::maxImageSize || height > PolygonManager::maxImageSize) { return badarguments; }
+	const std::string path(t[5].text, t[5].length);
+	return handle->render(path.c_str(), width, height, format, rule) ? ok : filefailed;
+}
+
+// stats: print the command statistics. stats reset: start them again. stats <file>: write them as JSON.
+const BatchRunner::Status BatchRunner::statscommand(const Token* t, const std::size_t n)
+{
+	if (n > 2) { return badarguments; }
+	if (n == 1) {
+		handle->stats().print();
+		return ok;
+	}
+	if (matches(t[1], "reset")) {
+		handle->stats().reset();
+		return ok;
+	}
+	const std::string path(t[1].text, t[1].length);
+	return handle->stats().writejson(path.c_str()) ? ok : filefailed;
+}
+
+// save <file>, load <file>. The file name is the rest of the token, so it can't contain spaces.
+const BatchRunner::Status BatchRunner::filecommand(const Token* t, const std::size_t n)
+{
+	if (n != 2) { return badarguments; }
+	const std::string path(t[1].text, t[1].length);
+	const bool done{ matches(t[0], "save") ? handle->save(path.c_str()) : handle->load(path.c_str()) };
+	return done ? ok : filefailed;
+}
+
+// import wkt|csv <file>, export wkt|csv <file>
+const BatchRunner::Status BatchRunner::textcommand(const Token* t, const std::size_t n)
+{
+	if (n != 3) { return badarguments; }
+	PolygonManager::TextFormat format;
+	if (matches(t[1], "wkt")) { format = PolygonManager::wkt; }
+	else if (matches(t[1], "csv")) { format = PolygonManager::csv; }
+	else { return badarguments; }
+	const std::string path(t[2].text, t[2].length);
+	const bool done{ matches(t[0], "import") ? handle->importtext(path.c_str(), format)
+		: handle->exporttext(path.c_str(), format) };
+	return done ? ok : filefailed;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+// BatchRunner.h
+// Headless alternative to InputHandler: runs a script of commands, one per line, from a file or stdin with no
+// prompts or menus. E.g.
+//		add ngon 12 3.0
+//		rotate all 45
+//		move 2 -1.5 4
+// Blank lines and lines starting with '#' are skipped. Errors are reported with their line number, and the
+// rest of the script still runs.
+// Transformations between a 'begin' line and a 'commit' line are applied together, as a transaction (see
+// PolygonManager::begin()). A transaction still open when the script ends is committed, and reported as an
+// error.
+#pragma once
+
+#include <cstdio>
+#include <cstddef>
+#include <memory>
+#include "PolygonManager.h"
+
+class BatchRunner {
+public:
+	// Outcome of one line
+	enum Status {
+		ok,
+		stop, // 'finish' - skip the rest of the script
+		unknowncommand,
+		badarguments, // Wrong number of arguments, or one that isn't a valid number
+		outofrange, // No polygon with that number
+		linetoolong,
+		filefailed, // Couldn't save, load, import, export or render (the details are reported by PolygonManager)
+		unmatched // 'begin' in a transaction, or 'commit' outside one
+	};
+
+private:
+	// A token is a view into the line buffer, so tokenising allocates nothing
+	struct Token {
+		const char* text;
+		std::size_t length;
+	};
+
+	static const std::size_t maxTokens{ 8 };
+	static const std::size_t bufferSize{ 1 << 20 }; // Longest allowed line
+
+	PolygonManager* const handle;
+	std::unique_ptr<char[]> buffer;
+	std::size_t lineno;
+	std::size_t errors;
+
+	const Status execute(char* const line); // line is null-terminated
+	void report(const Status status);
+	const std::size_t endrun(); // Commit any open transaction, then return the number of errors
+
+	// Commands. t[0] is the command name.
+	const Status addcommand(const Token* t, const std::size_t n);
+	const Status removecommand(const Token* t, const std::size_t n);
+	const Status movecommand(const Token* t, const std::size_t n);
+	const Status rotcommand(const Token* t, const std::size_t n);
+	const Status rescalecommand(const Token* t, const std::size_t n);
+	const Status areacommand(const Token* t, const std::size_t n);
+	const Status listcommand(const Token* t, const std::size_t n);
+	const Status indexcommand(const Token* t, const std::size_t n);
+	const Status threadscommand(const Token* t, const std::size_t n);
+	const Status drawcommand(const Token* t, const std::size_t n);
+	const Status rendercommand(const Token* t, const std::size_t n);
+	const Status statscommand(const Token* t, const std::size_t n);
+	const Status filecommand(const Token* t, const std::size_t n); // save, load
+	const Status textcommand(const Token* t, const std::size_t n); // import, export
+
+	static const bool matches(const Token& t, const char* const word);
+
+	// Argument parsing: false if the token isn't a number (or a polygon number in range)
+	const bool readdouble(const Token& t, double& value) const;
+	const bool readuint(const Token& t, unsigned int& value) const;
+	const bool readpolygon(const Token& t, unsigned int& i) const;
+
+public:
+	BatchRunner(PolygonManager* pm);
+	~BatchRunner() {}
+
+	const std::size_t run(std::FILE* const in); // Returns the number of lines with errors
+	const std::size_t run(const char* const path); // "-" for stdin
+
+	static const char* message(const Status status);
+};
\ No newline at end of file
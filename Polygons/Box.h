@@ -0,0 +1,33 @@
+// Box.h
+// An axis-aligned bounding box, given by its lower-left and upper-right corners.
+#pragma once
+
+#include "Vector.h"
+
+struct Box {
+	Vector min, max;
+
+	constexpr Box() : min(), max() {}
+	constexpr Box(const Vector& min, const Vector& max) : min(min), max(max) {}
+
+	constexpr const double width() const { return max.getx() - min.getx(); }
+	constexpr const double height() const { return max.gety() - min.gety(); }
+
+	constexpr const Box merge(const Box& rhs) const // Smallest box containing both
+	{
+		return Box(Vector(min.getx() < rhs.min.getx() ? min.getx() : rhs.min.getx(),
+				min.gety() < rhs.min.gety() ? min.gety() : rhs.min.gety()),
+			Vector(max.getx() > rhs.max.getx() ? max.getx() : rhs.max.getx(),
+				max.gety() > rhs.max.gety() ? max.gety() : rhs.max.gety()));
+	}
+
+	constexpr const bool overlaps(const Box& rhs) const
+	{
+		return min.getx() <= rhs.max.getx() && rhs.min.getx() <= max.getx()
+			&& min.gety() <= rhs.max.gety() && rhs.min.gety() <= max.gety();
+	}
+	constexpr const bool contains(const Vector& v) const
+	{
+		return v.getx() >= min.getx() && v.getx() <= max.getx() && v.gety() >= min.gety() && v.gety() <= max.gety();
+	}
+};
\ No newline at end of file
@@ -0,0 +1,136 @@
+// CommandStats.cpp
+// Latency statistics for each kind of command run on the polygons.
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "CommandStats.h"
+
+namespace {
+	const char* const names[]{ "add", "remove", "move", "rotate", "rescale", "centre", "area", "list", "draw",
+		"render", "save", "load", "import", "export", "compact", "clear", "query", "commit" };
+
+	inline unsigned int highestbit(std::uint64_t v) // v > 0
+	{
+		unsigned int bit{ 0 };
+		while (v >>= 1) { bit++; }
+		return bit;
+	}
+}
+
+CommandStats::CommandStats() :
+	depth(0),
+	current(add),
+	pending(0)
+{
+	reset();
+}
+
+void CommandStats::reset()
+{
+	std::memset(entries, 0, sizeof(entries));
+	return;
+}
+
+const char* CommandStats::name(const Command command)
+{
+	return names[command];
+}
+
+// Buckets 0-3 hold 0-3 ns. After that, the bucket is given by the position of the highest set bit and the two
+// bits below it.
+const unsigned int CommandStats::bucket(const std::uint64_t ns)
+{
+	if (ns < 4) { return (unsigned int)ns; }
+	const unsigned int e{ highestbit(ns) };
+	return 4 * (e - 1) + (unsigned int)((ns >> (e - 2)) & 3);
+}
+
+const std::uint64_t CommandStats::bucketlimit(const unsigned int b)
+{
+	if (b < 4) { return b; }
+	const unsigned int e{ b / 4 + 1 };
+	const std::uint64_t lowest{ (std::uint64_t)(4 + b % 4) << (e - 2) };
+	return lowest + (std::uint64_t(1) << (e - 2)) - 1;
+}
+
+void CommandStats::begin(const Command command)
+{
+	if (depth++ != 0) { return; }
+	current = command;
+	pending = 0;
+	start = Clock::now();
+	return;
+}
+
+void CommandStats::end()
+{
+	if (--depth != 0) { return; }
+	const std::uint64_t ns{ (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count() };
+	Entry& entry{ entries[current] };
+	entry.count++;
+	entry.total += ns;
+	if (ns > entry.max) { entry.max = ns; }
+	entry.vertices += pending;
+	entry.histogram[bucket(ns)]++;
+	return;
+}
+
+// The top of the bucket holding the p-th percentile, but no more than the largest time actually seen
+const std::uint64_t CommandStats::percentile(const Entry& entry, const double p) const
+{
+	const std::uint64_t rank{ (std::uint64_t)(p * (entry.count - 1)) + 1 };
+	std::uint64_t seen{ 0 };
+	for (unsigned int b{ 0 }; b < buckets; b++) {
+		seen += entry.histogram[b];
+		if (seen >= rank) { return bucketlimit(b) < entry.max ? bucketlimit(b) : entry.max; }
+	}
+	return entry.max;
+}
+
+void CommandStats::print(std::ostream& os) const
+{
+	char line[160];
+	std::snprintf(line, sizeof(line), "%-8s %10s %12s %12s %12s %12s %12s %14s\n", "command", "count", "total ms",
+		"mean us", "p50 us", "p99 us", "max us", "vertices");
+	std::string text{ line };
+	for (int c{ 0 }; c < commands; c++) {
+		const Entry& entry{ entries[c] };
+		if (entry.count == 0) { continue; }
+		std::snprintf(line, sizeof(line), "%-8s %10llu %12.3f %12.3f %12.3f %12.3f %12.3f %14llu\n", names[c],
+			(unsigned long long)entry.count, 1e-6 * entry.total, 1e-3 * entry.total / entry.count,
+			1e-3 * percentile(entry, 0.5), 1e-3 * percentile(entry, 0.99), 1e-3 * entry.max,
+			(unsigned long long)entry.vertices);
+		text += line;
+	}
+	os.write(text.data(), text.size());
+}
+
+const bool CommandStats::writejson(const char* const path) const
+{
+	std::FILE* const out{ std::fopen(path, "w") };
+	if (out == nullptr) {
+		std::cerr << "Error: Could not open " << path << " for writing." << std::endl;
+		return false;
+	}
+	std::fprintf(out, "{\n  \"commands\": [");
+	bool first{ true };
+	for (int c{ 0 }; c < commands; c++) {
+		const Entry& entry{ entries[c] };
+		if (entry.count == 0) { continue; }
+		std::fprintf(out, "%s\n    { \"command\": \"%s\", \"count\": %llu, \"total_ns\": %llu, \"p50_ns\": %llu, "
+			"\"p99_ns\": %llu, \"max_ns\": %llu, \"vertices\": %llu }", first ? "" : ",", names[c],
+			(unsigned long long)entry.count, (unsigned long long)entry.total,
+			(unsigned long long)percentile(entry, 0.5), (unsigned long long)percentile(entry, 0.99),
+			(unsigned long long)entry.max, (unsigned long long)entry.vertices);
+		first = false;
+	}
+	std::fprintf(out, "\n  ]\n}\n");
+
+	const bool failed{ std::ferror(out) != 0 };
+	if (std::fclose(out) != 0 || failed) {
+		std::cerr << "Error: Could not write " << path << "." << std::endl;
+		return false;
+	}
+	return true;
+}
\ No newline at end of file
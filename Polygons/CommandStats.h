@@ -0,0 +1,73 @@
+// CommandStats.h
+// Latency statistics for each kind of command run on the polygons: how many times it has run, the total and
+// maximum time taken, a histogram of the times, and the number of vertices processed. Shown by the 'stats'
+// command, and can be written out as JSON.
+//
+// PolygonManager times each of its public operations with a Scope. Scopes can nest (e.g. centreall() calls
+// translateall()), and only the outermost one is recorded, so each command is counted once. When tracing is on
+// (see Trace.h), every scope, nested or not, is also traced as a span.
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include "Trace.h"
+
+class CommandStats {
+public:
+	enum Command { add, remove, move, rotate, rescale, centre, area, list, draw, render, save, load, importtext,
+		exporttext, compact, clear, query, commit, commands };
+
+	// Times the command from construction to destruction
+	class Scope {
+	private:
+		CommandStats& stats;
+		const trace::Span span;
+	public:
+		Scope(CommandStats& stats, const Command command) : stats(stats), span("manager", name(command))
+		{
+			stats.begin(command);
+		}
+		~Scope() { stats.end(); }
+		Scope(const Scope&) = delete;
+		Scope& operator= (const Scope&) = delete;
+	};
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	// Times (in ns) are bucketed on a log scale, with 4 buckets for each power of 2, so each bucket is at most
+	// 25% wide
+	static const unsigned int buckets{ 252 };
+	static const unsigned int bucket(const std::uint64_t ns);
+	static const std::uint64_t bucketlimit(const unsigned int b); // Largest time in bucket b
+
+	struct Entry {
+		std::uint64_t count;
+		std::uint64_t total, max; // ns
+		std::uint64_t vertices;
+		std::uint64_t histogram[buckets];
+	};
+	Entry entries[commands];
+
+	unsigned int depth; // Of nested scopes
+	Command current; // Command being timed by the outermost scope
+	Clock::time_point start;
+	std::uint64_t pending; // Vertices processed so far by the current command
+
+	void begin(const Command command);
+	void end();
+	const std::uint64_t percentile(const Entry& entry, const double p) const; // In ns
+
+public:
+	CommandStats();
+	~CommandStats() {}
+
+	static const char* name(const Command command);
+
+	void processed(const std::uint64_t vertices) { pending += vertices; } // Add to the current command's count
+	void reset();
+
+	void print(std::ostream& os = std::cout) const; // A table of the commands that have been run
+	const bool writejson(const char* const path) const; // Reports any problem to std::cerr
+};
\ No newline at end of file
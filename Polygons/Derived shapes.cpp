@@ -1,33 +1,54 @@
 // Derived shapes.cpp
 
+#include <new>
 #include "Derived shapes.h"
 
 // Specialised polygon constructors:
 
-Isosceles::Isosceles(const double base, const double height) :
-	SymmetricPoly(3)
+Isosceles::Isosceles(const double base, const double height, VertexStore* const store) :
+	SymmetricPoly(3, store)
 {
-	vertex(0) = Vector(0, 0.5*height);
-	vertex(1) = Vector(-0.5*base, -0.5*height);
-	vertex(2) = Vector(0.5*base, -0.5*height);
+	setvertex(0, Vector(0, 0.5*height));
+	setvertex(1, Vector(-0.5*base, -0.5*height));
+	setvertex(2, Vector(0.5*base, -0.5*height));
 }
 
-Rectangle::Rectangle(const double width, const double height) :
-	SymmetricPoly(4)
+Rectangle::Rectangle(const double width, const double height, VertexStore* const store) :
+	SymmetricPoly(4, store)
 {
 	const double a{ 0.5*width }, b{ 0.5*height };
-	vertex(0) = Vector(a, b);
-	vertex(1) = Vector(-a, b);
-	vertex(2) = Vector(-a, -b);
-	vertex(3) = Vector(a, -b);
+	setvertex(0, Vector(a, b));
+	setvertex(1, Vector(-a, b));
+	setvertex(2, Vector(-a, -b));
+	setvertex(3, Vector(a, -b));
 }
 
 // Factory functions:
 
-Polygon* fact::createGenPoly(const int n, const double R)
+Polygon* fact::createGenPoly(const int n, const double R, VertexStore* const store,
+	PolygonArena* const arena)
 {
 	Polygon* pGenPoly;
-	try { pGenPoly = new GeneralPoly(n, R); }
+	try {
+		pGenPoly = (arena == nullptr) ? new GeneralPoly(n, R, store)
+			: new (arena->allocate(sizeof(GeneralPoly))) GeneralPoly(n, R, store);
+	}
+	catch (std::bad_alloc memfail)
+	{
+		std::cerr << "Error: Failed to create a new GeneralPoly object." << std::endl;
+		exit(1);
+	}
+	return pGenPoly;
+}
+
+Polygon* fact::createGenPoly(const int n, const double* x, const double* y, VertexStore* const store,
+	PolygonArena* const arena)
+{
+	Polygon* pGenPoly;
+	try {
+		pGenPoly = (arena == nullptr) ? new GeneralPoly(n, x, y, store)
+			: new (arena->allocate(sizeof(GeneralPoly))) GeneralPoly(n, x, y, store);
+	}
 	catch (std::bad_alloc memfail)
 	{
 		std::cerr << "Error: Failed to create a new GeneralPoly object." << std::endl;
@@ -36,10 +57,14 @@ Polygon* fact::createGenPoly(const int n, const double R)
 	return pGenPoly;
 }
 
-Polygon* fact::createIsosceles(const double base, const double height)
+Polygon* fact::createIsosceles(const double base, const double height, VertexStore* const store,
+	PolygonArena* const arena)
 {
 	Polygon* pIsos;
-	try { pIsos = new Isosceles(base, height); }
+	try {
+		pIsos = (arena == nullptr) ? new Isosceles(base, height, store)
+			: new (arena->allocate(sizeof(Isosceles))) Isosceles(base, height, store);
+	}
 	catch (std::bad_alloc memfail)
 	{
 		std::cerr << "Error: Failed to create a new Isosceles object." << std::endl;
@@ -48,10 +73,14 @@ Polygon* fact::createIsosceles(const double base, const double height)
 	return pIsos;
 }
 
-Polygon* fact::createRectangle(const double width, const double height)
+Polygon* fact::createRectangle(const double width, const double height, VertexStore* const store,
+	PolygonArena* const arena)
 {
 	Polygon* pRect;
-	try { pRect = new Rectangle(width, height); }
+	try {
+		pRect = (arena == nullptr) ? new Rectangle(width, height, store)
+			: new (arena->allocate(sizeof(Rectangle))) Rectangle(width, height, store);
+	}
 	catch (std::bad_alloc memfail)
 	{
 		std::cerr << "Error: Failed to create a new Rectangle object." << std::endl;
@@ -60,10 +89,14 @@ Polygon* fact::createRectangle(const double width, const double height)
 	return pRect;
 }
 
-Polygon* fact::createPentagon(const double R)
+Polygon* fact::createPentagon(const double R, VertexStore* const store,
+	PolygonArena* const arena)
 {
 	Polygon* pPenta;
-	try { pPenta = new Pentagon(R); }
+	try {
+		pPenta = (arena == nullptr) ? new Pentagon(R, store)
+			: new (arena->allocate(sizeof(Pentagon))) Pentagon(R, store);
+	}
 	catch (std::bad_alloc memfail)
 	{
 		std::cerr << "Error: Failed to create a new Pentagon object." << std::endl;
@@ -72,15 +105,18 @@ Polygon* fact::createPentagon(const double R)
 	return pPenta;
 }
 
-Polygon* fact::createHexagon(const double R)
+Polygon* fact::createHexagon(const double R, VertexStore* const store,
+	PolygonArena* const arena)
 {
 	Polygon* pHexa;
-	try { pHexa = new Hexagon(R); }
+	try {
+		pHexa = (arena == nullptr) ? new Hexagon(R, store)
+			: new (arena->allocate(sizeof(Hexagon))) Hexagon(R, store);
+	}
 	catch (std::bad_alloc memfail)
 	{
 		std::cerr << "Error: Failed to create a new Hexagon object." << std::endl;
 		exit(1);
 	}
 	return pHexa;
-}
-
+}
\ No newline at end of file
@@ -8,25 +8,26 @@
 #pragma once
 
 #include "Polygon.h"
+#include "PolygonArena.h"
 
 class Isosceles : public SymmetricPoly {
 public:
-	Isosceles(const double base, const double height);
+	Isosceles(const double base, const double height, VertexStore* const store = nullptr);
 	~Isosceles() {}
 	const std::string name() const { return "Isosceles triangle"; }
 };
 
 class Rectangle : public SymmetricPoly {
 public:
-	Rectangle(const double width, const double height);
+	Rectangle(const double width, const double height, VertexStore* const store = nullptr);
 	~Rectangle() {}
 	const std::string name() const { return "Rectangle"; }
 };
 
 class Pentagon : public GeneralPoly {
 public:
-	Pentagon(const double R) :
-		GeneralPoly(5, R)
+	Pentagon(const double R, VertexStore* const store = nullptr) :
+		GeneralPoly(5, R, store)
 	{}
 	~Pentagon() {}
 	const std::string name() const { return "Pentagon"; }
@@ -34,8 +35,8 @@ public:
 
 class Hexagon : public GeneralPoly {
 public:
-	Hexagon(const double R) :
-		GeneralPoly(6, R)
+	Hexagon(const double R, VertexStore* const store = nullptr) :
+		GeneralPoly(6, R, store)
 	{}
 	~Hexagon() {}
 	const std::string name() const { return "Hexagon"; }
@@ -45,11 +46,20 @@ namespace fact {
 
 	// Factory functions: return a base class pointer to a newed polygon object.
 	// Each do exception handling to check and abort if allocation fails.
+	// If a store is given, the polygon's vertices are placed in it (see VertexStore.h). If an arena is given,
+	// the object itself is made there, and must be freed with arena->destroy() rather than delete.
 
-	Polygon* createGenPoly(const int n, const double R);
-	Polygon* createIsosceles(const double base, const double height);
-	Polygon* createRectangle(const double width, const double height);
-	Polygon* createPentagon(const double R);
-	Polygon* createHexagon(const double R);
+	Polygon* createGenPoly(const int n, const double R, VertexStore* const store = nullptr,
+		PolygonArena* const arena = nullptr);
+	Polygon* createGenPoly(const int n, const double* x, const double* y, VertexStore* const store = nullptr,
+		PolygonArena* const arena = nullptr); // With the vertices x, y
+	Polygon* createIsosceles(const double base, const double height, VertexStore* const store = nullptr,
+		PolygonArena* const arena = nullptr);
+	Polygon* createRectangle(const double width, const double height, VertexStore* const store = nullptr,
+		PolygonArena* const arena = nullptr);
+	Polygon* createPentagon(const double R, VertexStore* const store = nullptr,
+		PolygonArena* const arena = nullptr);
+	Polygon* createHexagon(const double R, VertexStore* const store = nullptr,
+		PolygonArena* const arena = nullptr);
 
 }
\ No newline at end of file
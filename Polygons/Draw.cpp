@@ -3,65 +3,117 @@
 
 // Uses the Bresenham line algorithm on all the lines of the polygons to fill a 2D 
 // array of bools - "pixels", which are then used tp draw to the console.
+// The pixels are a Framebuffer sized to the requested width and height, and each line is clipped to it
+// (Cohen-Sutherland) before it is drawn, so shapes can run off the edge of the image.
+//
+// The pixels are kept from one draw to the next. If the scale hasn't changed, only the tiles (see
+// Framebuffer.h) that changed polygons were or now are in are cleared, and only the polygons that reach
+// those tiles are drawn again. Drawing an unchanged polygon again sets exactly the same pixels as before, so
+// this gives the same image as drawing everything from scratch.
 
 // Disclaimer: Some of the guts of the algorithm has been taken from the Rosetta Code article
 // on the Bresenham line algorithm, which is open source. I've indicated where in the code.
 // The rest of the methods (boolean pixels, drawing method, scaling method etc) are mine.
 
+#include <algorithm>
 #include <cmath>
 #include <string>
 #include <iostream>
+#include <sstream>
+#include "Framebuffer.h"
 #include "PolygonManager.h"
+#include "Trace.h"
 
 using namespace std;
 
-void PolygonManager::draw() const
-{
-	// Set up the 'pixels'
-	bool pixels[100][80] = { false };
+namespace {
 
-	const double pixelAspectRatio{ 0.5 }; // x:y - Need to have fewer pixels in y direction to compensate, i.e. make image square
-	const unsigned int maxWidth{ drawWidth }; // 79 by default
-	const unsigned int maxHeight{ (const unsigned int)(pixelAspectRatio*drawWidth) };
-	
-	// Iterate over all the polygons' vertices to find the boundaries of our image, i.e. largest |x| or |y| value.
-	double maxX{ 0 };
-	for (auto it{ polygons.cbegin() }; it != polygons.cend(); it++)
+	// Cohen-Sutherland clipping: each end of a line gets an outcode saying which side(s) of the window it's off.
+	// If both ends are off the same side the line misses; otherwise an end that's outside is moved onto the
+	// edge it's off, and the test repeats.
+	enum Outcode { inside = 0, left = 1, right = 2, below = 4, above = 8 };
+
+	int outcode(const double x, const double y, const Box& window)
 	{
-		for (unsigned int i{ 0 }; i < (*it)->size(); i++) {
-			double newX{ (*it)->vertex(i)(1) }, newY{ (*it)->vertex(i)(2) };
-			if (fabs(newX) > maxX) { maxX = fabs(newX); }
-			if (fabs(newY) > maxX) { maxX = fabs(newY); }
-		}
+		int code{ inside };
+		if (x < window.min.getx()) { code |= left; }
+		else if (x > window.max.getx()) { code |= right; }
+		if (y < window.min.gety()) { code |= below; }
+		else if (y > window.max.gety()) { code |= above; }
+		return code;
 	}
-	maxX *= 1.2; // Add an extra 20% of free space around the image
 
-	// Will need to scale all vertex locations to give them in terms of pixel locations:
-	const double scaleX{ maxWidth / (2.0 * maxX) };
-	const double scaleY{ maxHeight / (2.0 * maxX) };
+	// Clip the line (x1, y1)-(x2, y2) to window. Returns false if none of it is inside.
+	bool clip(double& x1, double& y1, double& x2, double& y2, const Box& window)
+	{
+		int code1{ outcode(x1, y1, window) }, code2{ outcode(x2, y2, window) };
+		while (true)
+		{
+			if ((code1 | code2) == inside) { return true; }
+			if ((code1 & code2) != 0) { return false; }
 
-	const unsigned int midX{ maxWidth / 2 }, midY{ maxHeight / 2 };
+			const int code{ code1 != inside ? code1 : code2 };
+			double x, y;
+			if (code & above)
+			{
+				x = x1 + (x2 - x1) * (window.max.gety() - y1) / (y2 - y1);
+				y = window.max.gety();
+			}
+			else if (code & below)
+			{
+				x = x1 + (x2 - x1) * (window.min.gety() - y1) / (y2 - y1);
+				y = window.min.gety();
+			}
+			else if (code & right)
+			{
+				y = y1 + (y2 - y1) * (window.max.getx() - x1) / (x2 - x1);
+				x = window.max.getx();
+			}
+			else
+			{
+				y = y1 + (y2 - y1) * (window.min.getx() - x1) / (x2 - x1);
+				x = window.min.getx();
+			}
 
-	// Now iterate over polygons using the Bresenham line algorithm to populate pixels.
-	for (auto it{ polygons.cbegin() }; it != polygons.cend(); it++)
+			if (code == code1)
+			{
+				x1 = x;
+				y1 = y;
+				code1 = outcode(x1, y1, window);
+			}
+			else
+			{
+				x2 = x;
+				y2 = y;
+				code2 = outcode(x2, y2, window);
+			}
+		}
+	}
+
+	// How world coords map onto the pixels
+	struct View {
+		double scaleX, scaleY;
+		unsigned int midX, midY; // Pixel of the origin
+		Box window; // The image, relative to the origin (the coords are rounded towards 0)
+	};
+
+	// Draw the outline of poly using the Bresenham line algorithm
+	void rasterise(const Polygon& poly, const View& view, Framebuffer& pixels)
 	{
+		const double scaleX{ view.scaleX }, scaleY{ view.scaleY };
+		const unsigned int midX{ view.midX }, midY{ view.midY };
+		const Box& window{ view.window };
+		const double* const px{ poly.x() };
+		const double* const py{ poly.y() };
+
 		// Iterate over vertices to get lines
-		for (unsigned int i{ 0 }; i < (*it)->size(); i++)
+		for (unsigned int i{ 0 }; i < poly.size(); i++)
 		{
-			double x1, x2, y1, y2;
-			if (!(i == (*it)->size() - 1)) { // connect to next vertex if there is one
-				x1 = scaleX * (*it)->vertex(i)(1); 
-				x2 = scaleX * (*it)->vertex(i+1)(1);
-				y1 = scaleY * (*it)->vertex(i)(2);
-				y2 = scaleY * (*it)->vertex(i+1)(2);
-			}
-			else { // last vertex - connect to first vertex
-				x1 = scaleX * (*it)->vertex(i)(1);
-				x2 = scaleX * (*it)->vertex(0)(1);
-				y1 = scaleY * (*it)->vertex(i)(2);
-				y2 = scaleY * (*it)->vertex(0)(2);
-			}
-			
+			const unsigned int j{ (i == poly.size() - 1) ? 0 : i + 1 }; // connect to next vertex, or last to first
+			double x1{ scaleX * px[i] }, x2{ scaleX * px[j] };
+			double y1{ scaleY * py[i] }, y2{ scaleY * py[j] };
+			if (!clip(x1, y1, x2, y2, window)) { continue; }
+		
 			// The next few lines were borrowed from Rosetta Code
 			const bool steep = (fabs(y2 - y1) > fabs(x2 - x1)); 
 			if (steep)
@@ -87,15 +139,16 @@ void PolygonManager::draw() const
 
 			for (int x = (int)x1; x<maxX; x++)
 			{
+				// Rounding can leave y one pixel off the edge
 				if (steep)
 				{
 					// set pixel at y,x
-					pixels[y + midX][x + midY] = true;
+					if (pixels.inside(y + midX, x + midY)) { pixels.set(y + midX, x + midY); }
 				}
 				else
 				{
 					// set pixel at x,y
-					pixels[x + midX][y + midY] = true;
+					if (pixels.inside(x + midX, y + midY)) { pixels.set(x + midX, y + midY); }
 				}
 
 				error -= dy;
@@ -108,37 +161,130 @@ void PolygonManager::draw() const
 		}
 	}
 
-	// Draw the pixels
-	for (int y{ (const int)maxHeight }; y >= 0; y--)
+	// The pixels that rasterise() could set for a polygon with the given bounding box: Bresenham can stray a
+	// pixel past the rounded ends of a line, so this allows a margin of 2
+	const Framebuffer::Region screenbox(const Box& box, const View& view, const Framebuffer& pixels)
+	{
+		const auto clamp = [](const double v, const double hi) { return (int)fmax(-1.0, fmin(v, hi)); };
+		Framebuffer::Region p;
+		p.left = clamp(floor(view.scaleX * box.min.getx()) + view.midX - 2, pixels.width());
+		p.right = clamp(ceil(view.scaleX * box.max.getx()) + view.midX + 2, pixels.width());
+		p.bottom = clamp(floor(view.scaleY * box.min.gety()) + view.midY - 2, pixels.height());
+		p.top = clamp(ceil(view.scaleY * box.max.gety()) + view.midY + 2, pixels.height());
+		return p;
+	}
+
+}
+
+void PolygonManager::draw(std::ostream& os) const
+{
+	const CommandStats::Scope scope(commandstats, CommandStats::draw);
+	commandstats.processed(vertextotal);
+	const double pixelAspectRatio{ 0.5 }; // x:y - Need to have fewer pixels in y direction to compensate, i.e. make image square
+	const unsigned int maxWidth{ drawWidth }; // 79 by default
+	const unsigned int maxHeight{ drawHeight != 0 ? drawHeight : (const unsigned int)(pixelAspectRatio*drawWidth) };
+	if (maxWidth == 0) { return; }
+	
+	// Bring every polygon's world vertices up to date (see Polygon.h), and find the boundaries of our image,
+	// i.e. largest |x| or |y| value. The polygons' bounding boxes are cached, so this doesn't need to look at
+	// the vertices.
+	Box scene;
 	{
-		string line;
-		for (int x{ 0 }; x < maxWidth; x++)
+		TRACE_SCOPE("draw", "extents");
+		forall([](const Polygon* poly) { poly->materialise(); });
+		scene = extents();
+	}
+	double maxX{ fmax(fmax(fabs(scene.min.getx()), fabs(scene.max.getx())), fmax(fabs(scene.min.gety()), fabs(scene.max.gety()))) };
+	maxX *= 1.2; // Add an extra 20% of free space around the image
+
+	// Will need to scale all vertex locations to give them in terms of pixel locations:
+	View view;
+	view.scaleX = maxWidth / (2.0 * maxX);
+	view.scaleY = maxHeight / (2.0 * maxX);
+	view.midX = maxWidth / 2;
+	view.midY = maxHeight / 2;
+	view.window = Box(Vector(-(double)view.midX, -(double)view.midY),
+		Vector((double)maxWidth - 1 - view.midX, (double)maxHeight - view.midY));
+	const unsigned int midX{ view.midX }, midY{ view.midY };
+
+	// Set up the 'pixels' - rows 0,...,maxHeight from the bottom up
+	Framebuffer& pixels{ frame };
+	const bool fresh{ pixels.width() != maxWidth || pixels.height() != maxHeight + 1 || frameScale != view.scaleX };
+	if (fresh) {
+		TRACE_SCOPE("draw", "rasterise");
+		pixels.resize(maxWidth, maxHeight + 1);
+		for (std::size_t i{ 0 }; i < polygons.size(); i++)
 		{
-			if (!pixels[x][y] && x != midX && y != midY)
-			{
-				line += " "; // empty space
-			}
-			else if (!pixels[x][y] && x != midX && y == midY)
-			{
-				line += "-"; // x-axis
-			}
-			else if (!pixels[x][y] && x == midX && y != midY)
-			{
-				line += "|"; // y-axis
+			rasterise(*polygons[i], view, pixels);
+			drawn[i] = screenbox(polygons[i]->bounds(), view, pixels);
+		}
+	}
+	else {
+		TRACE_SCOPE("draw", "rasterise (incremental)");
+		// Find the tiles to redraw: wherever a changed polygon was drawn before or will be drawn now
+		const unsigned int columns{ pixels.tilecolumns() }, rows{ pixels.tilerows() };
+		std::vector<char> damaged(columns * rows, 0);
+		bool anydamage{ false };
+		const auto tiles = [&](const Framebuffer::Region& p, const bool mark) {
+			if (p.left > p.right || p.bottom > p.top) { return false; }
+			const int tx0{ std::max(p.left, 0) / (int)Framebuffer::tileWidth };
+			const int tx1{ std::min(p.right, (int)maxWidth - 1) / (int)Framebuffer::tileWidth };
+			const int ty0{ std::max(p.bottom, 0) / (int)Framebuffer::tileHeight };
+			const int ty1{ std::min(p.top, (int)maxHeight) / (int)Framebuffer::tileHeight };
+			for (int ty{ ty0 }; ty <= ty1; ty++) {
+				for (int tx{ tx0 }; tx <= tx1; tx++) {
+					if (mark) { damaged[ty * columns + tx] = 1; }
+					else if (damaged[ty * columns + tx]) { return true; }
+				}
 			}
-			else if (!pixels[x][y] && x == midX && y == midY)
-			{
-				line += "O"; // origin
+			anydamage = anydamage || mark;
+			return false;
+		};
+		for (auto it = erased.cbegin(); it != erased.cend(); it++) { tiles(*it, true); }
+		for (std::size_t i{ 0 }; i < polygons.size(); i++) {
+			if (!dirty[i]) { continue; }
+			tiles(drawn[i], true);
+			drawn[i] = screenbox(polygons[i]->bounds(), view, pixels);
+			tiles(drawn[i], true);
+		}
+
+		if (anydamage) {
+			for (unsigned int ty{ 0 }; ty < rows; ty++) {
+				for (unsigned int tx{ 0 }; tx < columns; tx++) {
+					if (damaged[ty * columns + tx]) { pixels.cleartile(tx, ty); }
+				}
 			}
-			else if (pixels[x][y])
-			{
-				line += "x"; // shape!
+			for (std::size_t i{ 0 }; i < polygons.size(); i++) {
+				if (dirty[i] || tiles(drawn[i], false)) { rasterise(*polygons[i], view, pixels); }
 			}
 		}
-		cout << line << endl;
 	}
-	cout << endl;
+	frameScale = view.scaleX;
+	std::fill(dirty.begin(), dirty.end(), 0);
+	erased.clear();
+
+	// Draw the pixels, into one buffer: each row is filled with the background (axes or empty space) and then
+	// the shapes are put on top
+	TRACE_SCOPE("draw", "output");
+	string text;
+	text.reserve((std::size_t(maxWidth) + 1) * (std::size_t(maxHeight) + 1) + 64);
+	for (int y{ (const int)maxHeight }; y >= 0; y--)
+	{
+		const size_t start{ text.size() };
+		text.append(maxWidth, y == (const int)midY ? '-' : ' '); // x-axis, or empty space
+		text[start + midX] = (y == (const int)midY) ? 'O' : '|'; // origin, or y-axis
+		for (unsigned int x{ 0 }; x < maxWidth; x++)
+		{
+			if (pixels.get(x, y)) { text[start + x] = 'x'; } // shape!
+		}
+		text += '\n';
+	}
+	text += '\n';
 	
-	// Print image size
-	cout << "The width of the image is " << 2 * maxX << " units." << endl;
+	// Image size - formatted as it would be by os
+	ostringstream number;
+	number.copyfmt(os);
+	number << 2 * maxX;
+	text += "The width of the image is " + number.str() + " units.\n";
+	os.write(text.data(), text.size());
 }
\ No newline at end of file
@@ -0,0 +1,49 @@
+// Framebuffer.h
+// A black and white image of any size, used by PolygonManager::draw(). Stored one bit per pixel, packed into
+// 64-bit words row by row, so clearing or scanning it touches 64 pixels at a time. For partial redraws it is
+// split into tiles of 64 x 8 pixels, i.e. the same word in each of 8 rows.
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+class Framebuffer {
+private:
+	unsigned int w, h;
+	std::size_t stride; // Words per row
+	std::vector<std::uint64_t> bits;
+
+public:
+	Framebuffer() : w(0), h(0), stride(0) {}
+	Framebuffer(const unsigned int width, const unsigned int height) : w(0), h(0), stride(0) { resize(width, height); }
+	~Framebuffer() {}
+
+	const unsigned int width() const { return w; }
+	const unsigned int height() const { return h; }
+
+	void resize(const unsigned int width, const unsigned int height) // Also clears the image
+	{
+		w = width;
+		h = height;
+		stride = (width + 63) / 64;
+		bits.assign(stride * height, 0);
+	}
+	void clear() { std::fill(bits.begin(), bits.end(), 0); }
+
+	struct Region { int left, bottom, right, top; }; // Inclusive ranges of pixels; empty if left > right
+
+	static const unsigned int tileWidth{ 64 }, tileHeight{ 8 };
+	const unsigned int tilecolumns() const { return (unsigned int)stride; }
+	const unsigned int tilerows() const { return (h + tileHeight - 1) / tileHeight; }
+	void cleartile(const unsigned int tx, const unsigned int ty)
+	{
+		for (unsigned int y{ ty * tileHeight }; y < h && y < (ty + 1) * tileHeight; y++) { bits[y * stride + tx] = 0; }
+	}
+
+	const bool inside(const int x, const int y) const { return (unsigned int)x < w && (unsigned int)y < h; }
+
+	// No range checking - see inside()
+	void set(const unsigned int x, const unsigned int y) { bits[y * stride + x / 64] |= std::uint64_t(1) << (x % 64); }
+	const bool get(const unsigned int x, const unsigned int y) const { return (bits[y * stride + x / 64] >> (x % 64)) & 1; }
+};
\ No newline at end of file
@@ -3,6 +3,8 @@
 // in the object manager. It holds a pointer to an existing object manager. 
 
 #include "InputHandler.h"
+#include "Trace.h"
+#include "UnitCircle.h"
 using namespace std;
 
 // Constructor / Destructor
@@ -37,8 +39,16 @@ void InputHandler::listinputcommands() const
 	cout << "	'rotate'	- Rotate a polygon (or all) by a specified angle" << endl;
 	cout << "	'rescale'	- Rescale a polygon" << endl;
 	cout << "	'centre'	- Centres all the polygons collectively" << endl;
+	cout << "	'begin'		- Start collecting transformations, to apply together" << endl;
+	cout << "	'commit'	- Apply the transformations collected since 'begin'" << endl;
 	cout << "	'area'		- Calculate the area of a polygon" << endl;
 	cout << "	'draw'		- Draw the polygons to the console" << endl;
+	cout << "	'render'	- Render the polygons, filled, to a PBM or PGM image file" << endl;
+	cout << "	'save'		- Save the polygons to a file" << endl;
+	cout << "	'load'		- Load polygons from a file, replacing the current ones" << endl;
+	cout << "	'import'	- Add polygons from a WKT or CSV file" << endl;
+	cout << "	'export'	- Write the polygons to a WKT or CSV file" << endl;
+	cout << "	'stats'		- Show how long each type of command has taken" << endl;
 	cout << "	'finish'	- End the program" << endl;
 	cout << "If you have entered a command and wish to cancel it, enter 0." << endl;
 }
@@ -66,6 +76,7 @@ void InputHandler::getinput()
 void InputHandler::getcommand()
 {
 	string command{ readinput<string>() };
+	const trace::Span span("command", command.data(), command.size());
 
 	if (command.compare("add") == 0) { addcommand(); }
 	else if (command.compare("remove") == 0) { removecommand(); }
@@ -76,6 +87,14 @@ void InputHandler::getcommand()
 	else if (command.compare("centre") == 0) { handle->centreall(); cout << "Polygons centred." << endl; }
 	else if (command.compare("area") == 0) { areacommand(); }
 	else if (command.compare("draw") == 0) { handle->draw(); }
+	else if (command.compare("render") == 0) { rendercommand(); }
+	else if (command.compare("save") == 0) { savecommand(); }
+	else if (command.compare("load") == 0) { loadcommand(); }
+	else if (command.compare("import") == 0) { textcommand(true); }
+	else if (command.compare("export") == 0) { textcommand(false); }
+	else if (command.compare("stats") == 0) { statscommand(); }
+	else if (command.compare("begin") == 0) { begincommand(); }
+	else if (command.compare("commit") == 0) { commitcommand(); }
 	else if (command.compare("finish") == 0) { isRunning = false; } // Cuts the main loop
 	else {
 		cout << "Invalid input." << endl;
@@ -327,7 +346,7 @@ void InputHandler::movecommand() const
 // Rotate one or all polygons
 void InputHandler::rotcommand() const
 {
-	const double pi{ 3.14159265 };
+	using circle::pi;
 	cout << "Please enter the number of the polygon you wish to rotate, or enter 'all', \nor 0 to cancel:" << endl;
 	handle->listshapes();
 	try {
@@ -472,4 +491,199 @@ const std::string lowercase(std::string str) {
 		lower += tolower(str.at(i));
 	}
 	return lower;
+}
+
+// Save command - write the whole scene to a snapshot file
+void InputHandler::savecommand() const
+{
+	cout << "Please enter the name of the file to save to, or 0 to cancel:" << endl;
+	try {
+		cout << ">";
+		clearcin();
+		string filename{ readinput<string>() };
+		if (filename.compare("0") == 0) {
+			cout << "Command cancelled." << endl;
+			return;
+		}
+		if (handle->save(filename.c_str())) { cout << handle->count() << " polygons saved to " << filename << "." << endl; }
+		return;
+	}
+	catch (int flag) {
+		if (flag == bad_input) {
+			cout << "Invalid input." << endl;
+			return;
+		}
+	}
+}
+
+// Load command - replace the scene with one from a snapshot file
+void InputHandler::loadcommand() const
+{
+	cout << "Please enter the name of the file to load, or 0 to cancel:" << endl;
+	try {
+		cout << ">";
+		clearcin();
+		string filename{ readinput<string>() };
+		if (filename.compare("0") == 0) {
+			cout << "Command cancelled." << endl;
+			return;
+		}
+		if (handle->load(filename.c_str())) { cout << handle->count() << " polygons loaded from " << filename << "." << endl; }
+		return;
+	}
+	catch (int flag) {
+		if (flag == bad_input) {
+			cout << "Invalid input." << endl;
+			return;
+		}
+	}
+}
+
+// Import and export commands - polygons as WKT or CSV text
+void InputHandler::textcommand(const bool importing) const
+{
+	cout << "Please enter the format (wkt or csv), or 0 to cancel:" << endl;
+	try {
+		cout << ">";
+		clearcin();
+		const string name{ lowercase(readinput<string>()) };
+		if (name.compare("0") == 0) {
+			cout << "Command cancelled." << endl;
+			return;
+		}
+		PolygonManager::TextFormat format;
+		if (name.compare("wkt") == 0) { format = PolygonManager::wkt; }
+		else if (name.compare("csv") == 0) { format = PolygonManager::csv; }
+		else { throw bad_input; }
+
+		cout << "Please enter the name of the file, or 0 to cancel:" << endl;
+		cout << ">";
+		clearcin();
+		string filename{ readinput<string>() };
+		if (filename.compare("0") == 0) {
+			cout << "Command cancelled." << endl;
+			return;
+		}
+		if (importing) {
+			const int before{ handle->count() };
+			if (handle->importtext(filename.c_str(), format)) {
+				cout << handle->count() - before << " polygons imported from " << filename << "." << endl;
+			}
+		}
+		else if (handle->exporttext(filename.c_str(), format)) {
+			cout << handle->count() << " polygons exported to " << filename << "." << endl;
+		}
+		return;
+	}
+	catch (int flag) {
+		if (flag == bad_input) {
+			cout << "Invalid input." << endl;
+			return;
+		}
+	}
+}
+
+// Render command - a filled image of the scene, to a file
+void InputHandler::rendercommand() const
+{
+	cout << "Please enter the format (pbm or pgm), or 0 to cancel:" << endl;
+	try {
+		cout << ">";
+		clearcin();
+		const string formatname{ lowercase(readinput<string>()) };
+		if (formatname.compare("0") == 0) {
+			cout << "Command cancelled." << endl;
+			return;
+		}
+		PolygonManager::ImageFormat format;
+		if (formatname.compare("pbm") == 0) { format = PolygonManager::pbm; }
+		else if (formatname.compare("pgm") == 0) { format = PolygonManager::pgm; }
+		else { throw bad_input; }
+
+		cout << "Please enter the fill rule (evenodd or nonzero), or 0 to cancel:" << endl;
+		cout << ">";
+		clearcin();
+		const string rulename{ lowercase(readinput<string>()) };
+		if (rulename.compare("0") == 0) {
+			cout << "Command cancelled." << endl;
+			return;
+		}
+		PolygonManager::FillRule rule;
+		if (rulename.compare("evenodd") == 0) { rule = PolygonManager::evenodd; }
+		else if (rulename.compare("nonzero") == 0) { rule = PolygonManager::nonzero; }
+		else { throw bad_input; }
+
+		cout << "Please enter the width and height of the image in pixels, or 0 to cancel:" << endl;
+		cout << ">";
+		clearcin();
+		const int width{ readinput<int>() };
+		if (width == 0) {
+			cout << "Command cancelled." << endl;
+			return;
+		}
+		const int height{ readinput<int>() };
+		if (width < 0 || height <= 0) { throw bad_input; }
+		const int maxSize{ (const int)PolygonManager::maxImageSize };
+		if (width > maxSize || height > maxSize) { throw bad_input; }
+
+		cout << "Please enter the name of the file, or 0 to cancel:" << endl;
+		cout << ">";
+		clearcin();
+		const string filename{ readinput<string>() };
+		if (filename.compare("0") == 0) {
+			cout << "Command cancelled." << endl;
+			return;
+		}
+		if (handle->render(filename.c_str(), width, height, format, rule)) {
+			cout << "Rendered " << handle->count() << " polygons to " << filename << "." << endl;
+		}
+		return;
+	}
+	catch (int flag) {
+		if (flag == bad_input) {
+			cout << "Invalid input." << endl;
+			return;
+		}
+	}
+}
+
+// Stats command - show the command statistics, and optionally write them to a file as JSON
+void InputHandler::statscommand() const
+{
+	handle->stats().print();
+	cout << "Please enter the name of a file to write these to as JSON, or 0 to skip:" << endl;
+	try {
+		cout << ">";
+		clearcin();
+		const string filename{ readinput<string>() };
+		if (filename.compare("0") == 0) { return; }
+		if (handle->stats().writejson(filename.c_str())) { cout << "Statistics written to " << filename << "." << endl; }
+		return;
+	}
+	catch (int flag) {
+		if (flag == bad_input) {
+			cout << "Invalid input." << endl;
+			return;
+		}
+	}
+}
+
+// Transactions
+void InputHandler::begincommand() const
+{
+	if (!handle->begin()) {
+		cout << "Already collecting transformations - enter 'commit' to apply them." << endl;
+		return;
+	}
+	cout << "Collecting transformations: they will be applied together when you enter 'commit'." << endl;
+	cout << "Until then, 'list', 'draw' etc will still show the polygons where they are now." << endl;
+}
+
+void InputHandler::commitcommand() const
+{
+	if (!handle->commit()) {
+		cout << "There are no transformations to apply - enter 'begin' first." << endl;
+		return;
+	}
+	cout << "Transformations applied." << endl;
 }
\ No newline at end of file
@@ -23,6 +23,13 @@ private:
 	void rotcommand() const;
 	void rescalecommand() const;
 	void areacommand() const;
+	void savecommand() const;
+	void loadcommand() const;
+	void textcommand(const bool importing) const; // import, export
+	void rendercommand() const;
+	void statscommand() const;
+	void begincommand() const;
+	void commitcommand() const;
 	
 	template<class T>
 	const T readinput() const;
@@ -0,0 +1,202 @@
+// Kernels.cpp
+// Batch kernels - scalar, SSE2 and AVX2 versions, plus the runtime dispatch between them.
+
+// The SIMD versions are only built for x86/x64. The AVX2 one is compiled with a per-function target
+// attribute on GCC/Clang (MSVC allows AVX intrinsics without any special flags), so the rest of the program
+// doesn't need to be built for AVX2 and will still run on older CPUs.
+
+#include "Kernels.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define KERNELS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+
+	// Scalar version: this is also used to finish off the last few elements in the SIMD versions.
+
+	void transform_scalar(const double* x, const double* y, double* outx, double* outy, const std::size_t n,
+		const double m[6])
+	{
+		const double a{ m[0] }, b{ m[1] }, tx{ m[2] }, c{ m[3] }, d{ m[4] }, ty{ m[5] };
+		for (std::size_t i{ 0 }; i < n; i++) {
+			const double oldx{ x[i] }, oldy{ y[i] };
+			outx[i] = a * oldx + b * oldy + tx;
+			outy[i] = c * oldx + d * oldy + ty;
+		}
+	}
+
+	// Crossing number. Rather than dividing to find where the edge crosses the point's y, the sign of the cross
+	// product (vj - vi) x (p - vi) says which side of the edge the point is on: for an upward edge the point is
+	// to the left if it is positive. Every version uses exactly this test, so they all agree on points that lie
+	// on an edge.
+
+	void crossings_scalar(const double* vx, const double* vy, const unsigned int n, const double* px,
+		const double* py, const std::size_t m, bool* inside)
+	{
+		for (std::size_t k{ 0 }; k < m; k++) {
+			const double x{ px[k] }, y{ py[k] };
+			bool in{ false };
+			for (unsigned int i{ 0 }, j{ n - 1 }; i < n; j = i++) {
+				const double dx{ vx[j] - vx[i] }, dy{ vy[j] - vy[i] };
+				const double cross{ dx * (y - vy[i]) - dy * (x - vx[i]) };
+				in ^= ((vy[i] > y) != (vy[j] > y)) & (dy > 0 ? cross > 0 : cross < 0);
+			}
+			inside[k] = in;
+		}
+	}
+
+#ifdef KERNELS_X86
+
+	// SSE2 version - two doubles per register. SSE2 is part of x64, so this is always available there.
+
+	void transform_sse2(const double* x, const double* y, double* outx, double* outy, const std::size_t n,
+		const double m[6])
+	{
+		const __m128d a{ _mm_set1_pd(m[0]) }, b{ _mm_set1_pd(m[1]) }, tx{ _mm_set1_pd(m[2]) };
+		const __m128d c{ _mm_set1_pd(m[3]) }, d{ _mm_set1_pd(m[4]) }, ty{ _mm_set1_pd(m[5]) };
+		std::size_t i{ 0 };
+		for (; i + 2 <= n; i += 2) {
+			const __m128d vx{ _mm_loadu_pd(x + i) }, vy{ _mm_loadu_pd(y + i) };
+			_mm_storeu_pd(outx + i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(a, vx), _mm_mul_pd(b, vy)), tx));
+			_mm_storeu_pd(outy + i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(c, vx), _mm_mul_pd(d, vy)), ty));
+		}
+		transform_scalar(x + i, y + i, outx + i, outy + i, n - i, m);
+	}
+
+	// The SIMD crossing-number kernels test a block of points against every edge in turn, keeping the parity of
+	// each point as an all-ones/all-zeros mask.
+
+	void crossings_sse2(const double* vx, const double* vy, const unsigned int n, const double* px,
+		const double* py, const std::size_t m, bool* inside)
+	{
+		const __m128d zero{ _mm_setzero_pd() };
+		std::size_t k{ 0 };
+		for (; k + 2 <= m; k += 2) {
+			const __m128d x{ _mm_loadu_pd(px + k) }, y{ _mm_loadu_pd(py + k) };
+			__m128d parity{ zero };
+			for (unsigned int i{ 0 }, j{ n - 1 }; i < n; j = i++) {
+				const double dx{ vx[j] - vx[i] }, dy{ vy[j] - vy[i] };
+				const __m128d xi{ _mm_set1_pd(vx[i]) }, yi{ _mm_set1_pd(vy[i]) };
+				const __m128d spans{ _mm_xor_pd(_mm_cmplt_pd(y, yi), _mm_cmplt_pd(y, _mm_set1_pd(vy[j]))) };
+				const __m128d cross{ _mm_sub_pd(_mm_mul_pd(_mm_set1_pd(dx), _mm_sub_pd(y, yi)),
+					_mm_mul_pd(_mm_set1_pd(dy), _mm_sub_pd(x, xi))) };
+				const __m128d left{ dy > 0 ? _mm_cmpgt_pd(cross, zero) : _mm_cmplt_pd(cross, zero) };
+				parity = _mm_xor_pd(parity, _mm_and_pd(spans, left));
+			}
+			const int bits{ _mm_movemask_pd(parity) };
+			inside[k] = (bits & 1) != 0;
+			inside[k + 1] = (bits & 2) != 0;
+		}
+		crossings_scalar(vx, vy, n, px + k, py + k, m - k, inside + k);
+	}
+
+	// AVX2 version - four doubles per register.
+
+	TARGET_AVX2 void transform_avx2(const double* x, const double* y, double* outx, double* outy,
+		const std::size_t n, const double m[6])
+	{
+		const __m256d a{ _mm256_set1_pd(m[0]) }, b{ _mm256_set1_pd(m[1]) }, tx{ _mm256_set1_pd(m[2]) };
+		const __m256d c{ _mm256_set1_pd(m[3]) }, d{ _mm256_set1_pd(m[4]) }, ty{ _mm256_set1_pd(m[5]) };
+		std::size_t i{ 0 };
+		for (; i + 4 <= n; i += 4) {
+			const __m256d vx{ _mm256_loadu_pd(x + i) }, vy{ _mm256_loadu_pd(y + i) };
+			_mm256_storeu_pd(outx + i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(a, vx), _mm256_mul_pd(b, vy)), tx));
+			_mm256_storeu_pd(outy + i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(c, vx), _mm256_mul_pd(d, vy)), ty));
+		}
+		transform_scalar(x + i, y + i, outx + i, outy + i, n - i, m);
+	}
+
+	TARGET_AVX2 void crossings_avx2(const double* vx, const double* vy, const unsigned int n, const double* px,
+		const double* py, const std::size_t m, bool* inside)
+	{
+		const __m256d zero{ _mm256_setzero_pd() };
+		std::size_t k{ 0 };
+		for (; k + 4 <= m; k += 4) {
+			const __m256d x{ _mm256_loadu_pd(px + k) }, y{ _mm256_loadu_pd(py + k) };
+			__m256d parity{ zero };
+			for (unsigned int i{ 0 }, j{ n - 1 }; i < n; j = i++) {
+				const double dx{ vx[j] - vx[i] }, dy{ vy[j] - vy[i] };
+				const __m256d xi{ _mm256_set1_pd(vx[i]) }, yi{ _mm256_set1_pd(vy[i]) };
+				const __m256d spans{ _mm256_xor_pd(_mm256_cmp_pd(y, yi, _CMP_LT_OQ),
+					_mm256_cmp_pd(y, _mm256_set1_pd(vy[j]), _CMP_LT_OQ)) };
+				const __m256d cross{ _mm256_sub_pd(_mm256_mul_pd(_mm256_set1_pd(dx), _mm256_sub_pd(y, yi)),
+					_mm256_mul_pd(_mm256_set1_pd(dy), _mm256_sub_pd(x, xi))) };
+				const __m256d left{ dy > 0 ? _mm256_cmp_pd(cross, zero, _CMP_GT_OQ) : _mm256_cmp_pd(cross, zero, _CMP_LT_OQ) };
+				parity = _mm256_xor_pd(parity, _mm256_and_pd(spans, left));
+			}
+			const int bits{ _mm256_movemask_pd(parity) };
+			for (int b{ 0 }; b < 4; b++) { inside[k + b] = (bits & (1 << b)) != 0; }
+		}
+		crossings_scalar(vx, vy, n, px + k, py + k, m - k, inside + k);
+	}
+
+	// CPU feature detection: AVX2 needs both the CPU support and the OS saving the YMM registers.
+	bool hasavx2()
+	{
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7) { return false; }
+		__cpuid(info, 1);
+		const bool osxsave{ (info[2] & (1 << 27)) != 0 }, avx{ (info[2] & (1 << 28)) != 0 };
+		if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) { return false; }
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") != 0;
+#endif
+	}
+
+#endif // KERNELS_X86
+
+	// Dispatch table, filled in once on first use.
+	struct Dispatch {
+		void(*transform)(const double*, const double*, double*, double*, const std::size_t, const double[6]);
+		void(*crossings)(const double*, const double*, const unsigned int, const double*, const double*,
+			const std::size_t, bool*);
+		const char* isa;
+	};
+
+	const Dispatch select()
+	{
+#ifdef KERNELS_X86
+		if (hasavx2()) { return Dispatch{ transform_avx2, crossings_avx2, "AVX2" }; }
+		return Dispatch{ transform_sse2, crossings_sse2, "SSE2" };
+#else
+		return Dispatch{ transform_scalar, crossings_scalar, "scalar" };
+#endif
+	}
+
+	const Dispatch& dispatch()
+	{
+		static const Dispatch table{ select() }; // Thread-safe initialisation
+		return table;
+	}
+
+}
+
+void kernel::transform(const double* x, const double* y, double* outx, double* outy, const std::size_t n,
+	const double m[6])
+{
+	dispatch().transform(x, y, outx, outy, n, m);
+}
+
+void kernel::crossings(const double* vx, const double* vy, const unsigned int n, const double* px,
+	const double* py, const std::size_t m, bool* inside)
+{
+	dispatch().crossings(vx, vy, n, px, py, m, inside);
+}
+
+const char* kernel::isa()
+{
+	return dispatch().isa;
+}
\ No newline at end of file
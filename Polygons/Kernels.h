@@ -0,0 +1,26 @@
+// Kernels.h
+// Batch kernels that run straight over arrays of x and y coords (e.g. a VertexStore).
+// Each kernel has a scalar, an SSE2 and an AVX2 version; the fastest one the CPU supports is picked
+// once at start-up.
+#pragma once
+
+#include <cstddef>
+
+namespace kernel {
+
+	// Applies the affine transformation m = (a b tx; c d ty) to n points, writing the results to outx, outy:
+	//		outx = a*x + b*y + tx
+	//		outy = c*x + d*y + ty
+	// The output arrays may be the same as the input arrays.
+	void transform(const double* x, const double* y, double* outx, double* outy, const std::size_t n,
+		const double m[6]);
+
+	// Crossing-number (even-odd) test of m points against the polygon with the n vertices vx, vy: inside[k] is
+	// set to whether point k is inside. A point counts as crossing edge (i, j) if it lies in the half-open
+	// y range [min(yi, yj), max(yi, yj)) and to the left of the edge.
+	void crossings(const double* vx, const double* vy, const unsigned int n, const double* px, const double* py,
+		const std::size_t m, bool* inside);
+
+	const char* isa(); // Name of the instruction set in use, e.g. "AVX2"
+
+}
\ No newline at end of file
@@ -9,11 +9,32 @@
 #include "Derived shapes.h"
 #include "PolygonManager.h"
 #include "InputHandler.h"
+#include "BatchRunner.h"
+#include "Trace.h"
 
 using namespace std;
 
-int main() {
+// Run with no arguments for the interactive prompt, or with '--batch <file>' to run a script of commands
+// ('--batch -' reads the script from stdin). '--trace <file>' writes a trace of the commands (see Trace.h).
+int main(int argc, char* argv[]) {
+	const char* batch{ nullptr };
+	const char* tracefile{ nullptr };
+	for (int i{ 1 }; i < argc; i += 2) {
+		const string option{ argv[i] };
+		if (i + 1 < argc && option.compare("--batch") == 0 && batch == nullptr) { batch = argv[i + 1]; }
+		else if (i + 1 < argc && option.compare("--trace") == 0 && tracefile == nullptr) { tracefile = argv[i + 1]; }
+		else {
+			cerr << "Usage: " << argv[0] << " [--trace <file>] [--batch <file>|-]" << endl;
+			return 1;
+		}
+	}
+	if (tracefile != nullptr && !trace::start(tracefile)) { return 1; }
+
 	PolygonManager polyMan;
+	if (batch != nullptr) {
+		BatchRunner runner(&polyMan);
+		return (runner.run(batch) == 0) ? 0 : 1;
+	}
 	InputHandler inpHan(&polyMan);
 
 	return 0;
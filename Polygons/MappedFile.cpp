@@ -0,0 +1,61 @@
+// MappedFile.cpp
+// Read-only memory mapping of a whole file.
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+
+MappedFile::MappedFile(const char* const path) :
+	bytes(nullptr),
+	length(0),
+	file(INVALID_HANDLE_VALUE),
+	mapping(nullptr)
+{
+	file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) { return; }
+	LARGE_INTEGER filesize;
+	if (!GetFileSizeEx(file, &filesize) || filesize.QuadPart == 0) { return; }
+	mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr) { return; }
+	bytes = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (bytes != nullptr) { length = (std::size_t)filesize.QuadPart; }
+}
+
+MappedFile::~MappedFile()
+{
+	if (bytes != nullptr) { UnmapViewOfFile(bytes); }
+	if (mapping != nullptr) { CloseHandle(mapping); }
+	if (file != INVALID_HANDLE_VALUE) { CloseHandle(file); }
+}
+
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const char* const path) :
+	bytes(nullptr),
+	length(0),
+	fd(-1)
+{
+	fd = open(path, O_RDONLY);
+	if (fd == -1) { return; }
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size == 0) { return; } // mmap can't map an empty file
+	void* const p{ mmap(nullptr, (std::size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0) };
+	if (p == MAP_FAILED) { return; }
+	bytes = static_cast<const char*>(p);
+	length = (std::size_t)info.st_size;
+}
+
+MappedFile::~MappedFile()
+{
+	if (bytes != nullptr) { munmap(const_cast<char*>(bytes), length); }
+	if (fd != -1) { close(fd); }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,28 @@
+// MappedFile.h
+// Read-only memory mapping of a whole file: mmap on POSIX systems, a file mapping object on Windows.
+// The contents can be used in place, and are only paged in from disk as they are touched.
+#pragma once
+
+#include <cstddef>
+
+class MappedFile {
+private:
+	const char* bytes; // nullptr if the file couldn't be mapped
+	std::size_t length;
+#ifdef _WIN32
+	void* file; // HANDLEs - kept as void* so this header doesn't need windows.h
+	void* mapping;
+#else
+	int fd;
+#endif
+
+public:
+	explicit MappedFile(const char* const path);
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator= (const MappedFile&) = delete;
+
+	const bool isopen() const { return bytes != nullptr; } // False if the file was missing or empty
+	const char* data() const { return bytes; }
+	const std::size_t size() const { return length; }
+};
\ No newline at end of file
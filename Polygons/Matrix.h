@@ -1,29 +1,68 @@
 // Matrix.h
 // A class for matrices - used in functions for transformations (rotation, rescaling)
+// Everything is defined inline (and constexpr where possible) so the compiler can fully inline the arithmetic
+// into the loops that use it. The class is trivially copyable.
 #pragma once
 
+#include <iostream>
+#include <cstdlib>
+#include <type_traits>
+#include "Access.h"
+
 class Matrix {
 private:
 	double data[4];
 
+	[[noreturn]] static void outofrange()
+	{
+		std::cerr << "Error: Attempted to access matrix element out of range." << std::endl;
+		exit(1);
+	}
+
 public:
-	Matrix();
-	Matrix(const double a, const double b, const double c, const double d);	// a	b
-																			// c	d
-	~Matrix() {}
-	Matrix(const Matrix& param);
+	constexpr Matrix() : data{ 0, 0, 0, 0 } {}
+	constexpr Matrix(const double a, const double b, const double c, const double d) : data{ a, b, c, d } {}	// a	b
+																													// c	d
 
-	const Matrix& operator= (const Matrix& rhs);
+	// Element access - 1-based, i.e. i, j = 1 or 2. Range checked according to Policy (see Access.h).
+	template<class Policy = access::Default>
+	constexpr const double& at(const int i, const int j) const
+	{
+		if constexpr (Policy::checked) { if (i < 1 || i > 2 || j < 1 || j > 2) { outofrange(); } }
+		return data[2 * (i - 1) + (j - 1)];
+	}
+	template<class Policy = access::Default>
+	double& at(const int i, const int j)
+	{
+		if constexpr (Policy::checked) { if (i < 1 || i > 2 || j < 1 || j > 2) { outofrange(); } }
+		return data[2 * (i - 1) + (j - 1)];
+	}
+	constexpr const double& operator() (const int i, const int j) const { return at(i, j); }
+	double& operator() (const int i, const int j) { return at(i, j); }
 
-	const double& operator() (const int i, const int j) const;
-	double& operator() (const int i, const int j);
+	constexpr const Matrix operator* (const Matrix& rhs) const
+	{
+		return Matrix(data[0] * rhs.data[0] + data[1] * rhs.data[2], data[0] * rhs.data[1] + data[1] * rhs.data[3],
+			data[2] * rhs.data[0] + data[3] * rhs.data[2], data[2] * rhs.data[1] + data[3] * rhs.data[3]);
+	}
 
-	const Matrix operator* (const Matrix& rhs) const;
+	constexpr const double det() const { return data[0] * data[3] - data[1] * data[2]; } // determinant
 
-	const double det() const; // determinant
+	friend constexpr const Matrix operator* (double lhs, const Matrix& rhs);
 };
 
+typedef Matrix Matrix2;
+static_assert(std::is_trivially_copyable<Matrix>::value, "Matrix must stay trivially copyable");
+
 // Additional operator overloads:
-const Matrix operator* (double lhs, const Matrix& rhs);
+constexpr const Matrix operator* (double lhs, const Matrix& rhs)
+{
+	return Matrix(lhs * rhs.data[0], lhs * rhs.data[1], lhs * rhs.data[2], lhs * rhs.data[3]);
+}
 
-std::ostream& operator<< (std::ostream& os, const Matrix& rhs);
\ No newline at end of file
+inline std::ostream& operator<< (std::ostream& os, const Matrix& rhs)
+{
+	os << rhs(1, 1) << "	" << rhs(1, 2) << std::endl;
+	os << rhs(2, 1) << "	" << rhs(2, 2);
+	return os;
+}
\ No newline at end of file
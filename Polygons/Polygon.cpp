@@ -1,32 +1,52 @@
 // Polygon.cpp
 // Abstract base class for polygons - an ordered set of vertex locations
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 #include "Polygon.h"
+#include "Kernels.h"
+#include "UnitCircle.h"
 
 // Constructor and destructor
-Polygon::Polygon(const unsigned int n) :
+Polygon::Polygon(const unsigned int n, VertexStore* const store) :
 	n(n),
-	vertices(new Vector[n])
+	ownstore(store == nullptr ? new VertexStore : nullptr),
+	store(store == nullptr ? ownstore.get() : store),
+	offset(this->store->allocate(n)),
+	stale(true),
+	localvalid(false),
+	localarea(0),
+	localconvex(false),
+	boxvalid(false)
 {
 	if (n < 3) {
 		std::cerr << "Error: Attempted to create a polygon with less than three vertices." << std::endl;
 		exit(1);
 	}
+}
 
-	if (vertices == nullptr) {
-		std::cerr << "Error: Polygon construction failed. Could not allocate memory for vertices." << std::endl;
-		exit(1);
-	}
+Polygon::~Polygon()
+{
+	store->release(offset, n);
 }
 
 Polygon::Polygon(const Polygon& poly) :
 	n(poly.n),
-	vertices(new Vector[poly.n])
+	ownstore(poly.ownstore ? new VertexStore : nullptr),
+	store(poly.ownstore ? ownstore.get() : poly.store),
+	offset(store->allocate(poly.n)),
+	pose(poly.pose),
+	stale(true),
+	localvalid(false),
+	localarea(0),
+	localconvex(false),
+	boxvalid(false)
 {
 	for (unsigned int i{ 0 }; i < size(); i++)
 	{
-		vertex(i) = poly.vertex(i); // Deep copy
+		localx()[i] = poly.store->localx()[poly.offset + i]; // Deep copy
+		localy()[i] = poly.store->localy()[poly.offset + i];
 	}
 }
 
@@ -35,59 +55,345 @@ Polygon& Polygon::operator= (const Polygon& poly)
 	if (&poly == this) { return *this; }
 	if (n != poly.n) {
 		std::cerr << "Error: Attempted to assign to a Polygon with unequal vertex count." << std::endl;
+		exit(1);
 	}
 	for (unsigned int i{ 0 }; i < size(); i++)
 	{
-		vertex(i) = poly.vertex(i); // Deep copy
+		localx()[i] = poly.store->localx()[poly.offset + i]; // Deep copy
+		localy()[i] = poly.store->localy()[poly.offset + i];
 	}
+	pose = poly.pose;
 	return *this;
 }
 
-// Accessors
-const Vector& Polygon::vertex(const unsigned int i) const
+// Lazy transformation functions:
+
+// Write pose(local) into the world arrays, using the batch kernel over this polygon's span
+void Polygon::materialise() const
 {
-	if (i >= size()) {
-		std::cerr << "Error: Attempted to access vertex out of range." << std::endl;
-		exit(1);
+	if (!stale) { return; }
+	double m[6];
+	pose.coefficients(m);
+	kernel::transform(store->localx() + offset, store->localy() + offset, store->x() + offset, store->y() + offset,
+		size(), m);
+	stale = false;
+	return;
+}
+
+void Polygon::bake()
+{
+	materialise();
+	for (unsigned int i{ 0 }; i < size(); i++) {
+		store->localx()[offset + i] = store->x()[offset + i];
+		store->localy()[offset + i] = store->y()[offset + i];
 	}
-	return vertices[i];
+	pose = Affine();
+	localvalid = false;
+	slabs.reset();
+	return;
 }
 
-Vector& Polygon::vertex(const unsigned int i)
+// Translations and scalings along the axes map the bounding box onto the new bounding box, so it can be updated
+// directly. Anything else (i.e. a rotation) means it will have to be recomputed.
+void Polygon::transform(const Affine& A)
 {
-	if (i >= size()) {
-		std::cerr << "Error: Attempted to access vertex out of range." << std::endl;
-		exit(1);
+	pose = A * pose;
+	stale = true;
+	if (boxvalid) {
+		const Matrix& L{ A.linear() };
+		if (L(1, 2) == 0 && L(2, 1) == 0) {
+			const Vector a{ A(box.min) }, b{ A(box.max) };
+			box = Box(Vector(std::fmin(a.getx(), b.getx()), std::fmin(a.gety(), b.gety())),
+				Vector(std::fmax(a.getx(), b.getx()), std::fmax(a.gety(), b.gety())));
+		}
+		else { boxvalid = false; }
 	}
-	return vertices[i];
+	return;
 }
 
-// Find centre position: average over vertices
-const Vector Polygon::centre() const {
-	Vector sum;
+void Polygon::setlocal(const double* x, const double* y, const Affine& newpose)
+{
+	std::copy(x, x + size(), localx());
+	std::copy(y, y + size(), localy());
+	pose = newpose;
+	return;
+}
+
+// Accessors
+void Polygon::outofrange()
+{
+	std::cerr << "Error: Attempted to access vertex out of range." << std::endl;
+	exit(1);
+}
+
+// Directly editing a vertex only makes sense in world coords, so any pose is baked in first. (In the
+// derived class ctors the pose is still the identity, so this is skipped.)
+void Polygon::setvertex(const unsigned int i, const Vector& v)
+{
+	if (i >= size()) { outofrange(); }
+	if (!pose.isidentity()) { bake(); }
+	localx()[i] = v.getx();
+	localy()[i] = v.gety();
+}
+
+// Work out the area, centre, bounding box and convexity of the local vertices. Only needed once, unless the local vertices change.
+// The area uses determinants of the matrix of vertices (formula on Wolfram Mathworld). The determinant of each
+// pair of neighbouring vertices is written out directly so the loop runs straight over the coordinate arrays.
+void Polygon::updatelocal() const
+{
+	if (localvalid) { return; }
+	const double* const px{ store->localx() + offset };
+	const double* const py{ store->localy() + offset };
+	const unsigned int last{ size() - 1 };
+	double sum{ 0 }, sumx{ 0 }, sumy{ 0 };
+	for (unsigned int i{ 0 }; i < last; i++)
+	{
+		sum += px[i] * py[i + 1] - px[i + 1] * py[i];
+		sumx += px[i];
+		sumy += py[i];
+	}
+	sum += px[last] * py[0] - px[0] * py[last]; // the last vertex links to the first
+	sumx += px[last];
+	sumy += py[last];
+
+	double minx{ px[0] }, maxx{ px[0] }, miny{ py[0] }, maxy{ py[0] };
+	for (unsigned int i{ 1 }; i < size(); i++) {
+		minx = std::fmin(minx, px[i]);
+		maxx = std::fmax(maxx, px[i]);
+		miny = std::fmin(miny, py[i]);
+		maxy = std::fmax(maxy, py[i]);
+	}
+
 	const double inv_size{ 1.0 / size() };
+	localarea = 0.5 * sum;
+	localcentre = Vector(inv_size * sumx, inv_size * sumy);
+	localbox = Box(Vector(minx, miny), Vector(maxx, maxy));
+
+	// Convex if every turn is the same way round and the edges only change between heading left and heading
+	// right twice (this rules out star shapes, which also turn the same way at every vertex)
+	bool left{ false }, right{ false };
+	unsigned int flips{ 0 };
+	double firstdx{ 0 }, lastdx{ 0 }; // Ignoring vertical edges
 	for (unsigned int i{ 0 }; i < size(); i++) {
-		sum += vertex(i);
+		const unsigned int j{ (i + 1) % size() }, k{ (i + 2) % size() };
+		const double dx1{ px[j] - px[i] }, dy1{ py[j] - py[i] }, dx2{ px[k] - px[j] }, dy2{ py[k] - py[j] };
+		const double turn{ dx1 * dy2 - dy1 * dx2 };
+		left = left || turn > 0;
+		right = right || turn < 0;
+		if (dx1 == 0) { continue; }
+		if (lastdx != 0 && (dx1 > 0) != (lastdx > 0)) { flips++; }
+		if (firstdx == 0) { firstdx = dx1; }
+		lastdx = dx1;
 	}
-	return inv_size * sum;
+	if (firstdx != 0 && (firstdx > 0) != (lastdx > 0)) { flips++; } // Wrap around to the first edge
+	localconvex = !(left && right) && flips <= 2;
+	localvalid = true;
+	return;
 }
 
-// Find the area of the polygon using determinants of the matrix of vertices (formula on Wolfram Mathworld)
+// Find centre position: average over vertices. Averaging commutes with the pose, so this is just the
+// average of the local vertices, transformed.
+const Vector Polygon::centre() const {
+	updatelocal();
+	return pose(localcentre);
+}
+
+// The pose scales all areas by |det(pose)|
 const double Polygon::area() const
 {
-	double sum{ 0 };
-	for (unsigned int i{ 0 }; i < size(); i++)
+	updatelocal();
+	return std::fabs(localarea * pose.det());
+}
+
+const Box Polygon::bounds() const
+{
+	if (boxvalid) { return box; }
+	materialise();
+	const double* const px{ store->x() + offset };
+	const double* const py{ store->y() + offset };
+	double minx{ px[0] }, maxx{ px[0] }, miny{ py[0] }, maxy{ py[0] };
+	for (unsigned int i{ 1 }; i < size(); i++) {
+		minx = std::fmin(minx, px[i]);
+		maxx = std::fmax(maxx, px[i]);
+		miny = std::fmin(miny, py[i]);
+		maxy = std::fmax(maxy, py[i]);
+	}
+	box = Box(Vector(minx, miny), Vector(maxx, maxy));
+	boxvalid = true;
+	return box;
+}
+
+// Ray-edge intersection: solve origin + t*d = p + u*e for each edge p -> p + e, with t >= 0 and 0 <= u <= 1.
+// Using 2D cross products, t = (p - origin) x e / (d x e) and u = (p - origin) x d / (d x e).
+const bool Polygon::raycast(const Vector& origin, const Vector& direction, double& t) const
+{
+	materialise();
+	const double* const px{ store->x() + offset };
+	const double* const py{ store->y() + offset };
+	const double dx{ direction.getx() }, dy{ direction.gety() };
+	bool hit{ false };
+	for (unsigned int i{ 0 }; i < size(); i++) {
+		const unsigned int j{ (i == size() - 1) ? 0 : i + 1 };
+		const double ex{ px[j] - px[i] }, ey{ py[j] - py[i] };
+		const double denom{ dx * ey - dy * ex };
+		if (denom == 0) { continue; } // Parallel
+		const double wx{ px[i] - origin.getx() }, wy{ py[i] - origin.gety() };
+		const double tedge{ (wx * ey - wy * ex) / denom };
+		const double u{ (wx * dy - wy * dx) / denom };
+		if (tedge >= 0 && u >= 0 && u <= 1 && (!hit || tedge < t)) {
+			t = tedge;
+			hit = true;
+		}
+	}
+	return hit;
+}
+
+// Containment. The points are taken into the local frame a batch at a time, and any outside the local
+// bounding box are dropped straight away. The rest are tested against the slabs if there are any, otherwise
+// against every edge with the crossing-number kernel.
+void Polygon::contains(const double* x, const double* y, const std::size_t m, bool* inside) const
+{
+	std::fill(inside, inside + m, false);
+	if (pose.det() == 0) { return; } // Flattened - no interior
+	updatelocal();
+	const double* const lx{ store->localx() + offset };
+	const double* const ly{ store->localy() + offset };
+	if (size() >= slabThreshold && !slabs) { slabs.reset(new SlabIndex(lx, ly, size())); }
+	const bool useslabs{ slabs && slabs->valid() };
+
+	double m6[6];
+	pose.inverse().coefficients(m6);
+	const std::size_t batch{ 256 };
+	double bx[batch], by[batch]; // Batch in local coords
+	double cx[batch], cy[batch]; // Candidates from the batch, i.e. those inside the local box
+	std::size_t which[batch];
+	bool hit[batch];
+	for (std::size_t begin{ 0 }; begin < m; begin += batch) {
+		const std::size_t count{ std::min(batch, m - begin) };
+		kernel::transform(x + begin, y + begin, bx, by, count, m6);
+		std::size_t candidates{ 0 };
+		for (std::size_t k{ 0 }; k < count; k++) {
+			cx[candidates] = bx[k];
+			cy[candidates] = by[k];
+			which[candidates] = k;
+			candidates += localbox.contains(Vector(bx[k], by[k])) ? 1 : 0;
+		}
+		if (useslabs) {
+			for (std::size_t k{ 0 }; k < candidates; k++) { hit[k] = slabs->contains(cx[k], cy[k]); }
+		}
+		else { kernel::crossings(lx, ly, size(), cx, cy, candidates, hit); }
+		for (std::size_t k{ 0 }; k < candidates; k++) { inside[begin + which[k]] = hit[k]; }
+	}
+	return;
+}
+
+// Overlap tests:
+
+namespace {
+	// Range of the projections of the n points x, y onto the axis (ax, ay)
+	void project(const double* x, const double* y, const unsigned int n, const double ax, const double ay,
+		double& lo, double& hi)
+	{
+		lo = hi = ax * x[0] + ay * y[0];
+		for (unsigned int i{ 1 }; i < n; i++) {
+			const double p{ ax * x[i] + ay * y[i] };
+			lo = std::fmin(lo, p);
+			hi = std::fmax(hi, p);
+		}
+	}
+
+	// Is there an edge of polygon a whose normal separates a and b?
+	bool separated(const double* ax, const double* ay, const unsigned int an, const double* bx, const double* by,
+		const unsigned int bn)
 	{
-		if (i == size() - 1) { // if it's the last vertex, link to the first
-			Matrix M(vertex(i)(1), vertex(i)(2), vertex(0)(1), vertex(0)(2));
-			sum += M.det();
+		for (unsigned int i{ 0 }, j{ an - 1 }; i < an; j = i++) {
+			const double nx{ ay[i] - ay[j] }, ny{ ax[j] - ax[i] };
+			double alo, ahi, blo, bhi;
+			project(ax, ay, an, nx, ny, alo, ahi);
+			project(bx, by, bn, nx, ny, blo, bhi);
+			if (ahi < blo || bhi < alo) { return true; }
 		}
-		else {
-			Matrix M(vertex(i)(1), vertex(i)(2), vertex(i+1)(1), vertex(i+1)(2));
-			sum += M.det();
+		return false;
+	}
+
+	// Sign of the turn p -> q -> r
+	int orientation(const double px, const double py, const double qx, const double qy, const double rx,
+		const double ry)
+	{
+		const double turn{ (qx - px) * (ry - py) - (qy - py) * (rx - px) };
+		return (turn > 0) - (turn < 0);
+	}
+
+	// Do the closed segments p1 -> p2 and q1 -> q2 intersect?
+	bool crossing(const double p1x, const double p1y, const double p2x, const double p2y, const double q1x,
+		const double q1y, const double q2x, const double q2y)
+	{
+		const int o1{ orientation(p1x, p1y, p2x, p2y, q1x, q1y) }, o2{ orientation(p1x, p1y, p2x, p2y, q2x, q2y) };
+		const int o3{ orientation(q1x, q1y, q2x, q2y, p1x, p1y) }, o4{ orientation(q1x, q1y, q2x, q2y, p2x, p2y) };
+		if (o1 != o2 && o3 != o4) { return true; }
+		// Collinear cases: touching if the segments' ranges overlap
+		const auto between = [](const double a, const double b, const double v) {
+			return v >= std::fmin(a, b) && v <= std::fmax(a, b);
+		};
+		const auto onsegment = [&](const double ax, const double ay, const double bx, const double by,
+			const double vx, const double vy) { return between(ax, bx, vx) && between(ay, by, vy); };
+		return (o1 == 0 && onsegment(p1x, p1y, p2x, p2y, q1x, q1y)) || (o2 == 0 && onsegment(p1x, p1y, p2x, p2y, q2x, q2y))
+			|| (o3 == 0 && onsegment(q1x, q1y, q2x, q2y, p1x, p1y)) || (o4 == 0 && onsegment(q1x, q1y, q2x, q2y, p2x, p2y));
+	}
+
+	// Indices i of the edges (i, i + 1) with bounding boxes that overlap region
+	void edgesnear(const double* x, const double* y, const unsigned int n, const Box& region,
+		std::vector<unsigned int>& edges)
+	{
+		for (unsigned int i{ 0 }; i < n; i++) {
+			const unsigned int j{ (i + 1 == n) ? 0 : i + 1 };
+			const Box edge(Vector(std::fmin(x[i], x[j]), std::fmin(y[i], y[j])),
+				Vector(std::fmax(x[i], x[j]), std::fmax(y[i], y[j])));
+			if (edge.overlaps(region)) { edges.push_back(i); }
 		}
 	}
-	return std::fabs(0.5 * sum);
+}
+
+const bool Polygon::convex() const
+{
+	updatelocal();
+	return localconvex;
+}
+
+// Both tests run on the world vertices. For non-convex polygons only edges near the overlap of the two
+// bounding boxes are checked against each other. If no edges cross, the polygons either don't overlap or one
+// is entirely inside the other, which is checked with the crossing-number kernel on one vertex of each.
+const bool Polygon::overlaps(const Polygon& poly) const
+{
+	const Box a{ bounds() }, b{ poly.bounds() };
+	if (!a.overlaps(b)) { return false; }
+	const double* const ax{ x() };
+	const double* const ay{ y() };
+	const double* const bx{ poly.x() };
+	const double* const by{ poly.y() };
+
+	if (convex() && poly.convex()) {
+		return !separated(ax, ay, size(), bx, by, poly.size()) && !separated(bx, by, poly.size(), ax, ay, size());
+	}
+
+	const Box region(Vector(std::fmax(a.min.getx(), b.min.getx()), std::fmax(a.min.gety(), b.min.gety())),
+		Vector(std::fmin(a.max.getx(), b.max.getx()), std::fmin(a.max.gety(), b.max.gety())));
+	std::vector<unsigned int> aedges, bedges;
+	edgesnear(ax, ay, size(), region, aedges);
+	edgesnear(bx, by, poly.size(), region, bedges);
+	for (auto i = aedges.cbegin(); i != aedges.cend(); i++) {
+		const unsigned int i2{ (*i + 1 == size()) ? 0 : *i + 1 };
+		for (auto j = bedges.cbegin(); j != bedges.cend(); j++) {
+			const unsigned int j2{ (*j + 1 == poly.size()) ? 0 : *j + 1 };
+			if (crossing(ax[*i], ay[*i], ax[i2], ay[i2], bx[*j], by[*j], bx[j2], by[j2])) { return true; }
+		}
+	}
+
+	bool inside;
+	kernel::crossings(bx, by, poly.size(), ax, ay, 1, &inside); // First vertex of this polygon in poly?
+	if (inside) { return true; }
+	kernel::crossings(ax, ay, size(), bx, by, 1, &inside);
+	return inside;
 }
 
 // Transformations:
@@ -95,89 +401,133 @@ const double Polygon::area() const
 // Translate each vertex by vector r
 void Polygon::translate(const Vector& r)
 {
-	for (unsigned int i{ 0 }; i < size(); i++) {
-		vertex(i) += r;
-	}
+	Motion m;
+	translate(m, r);
+	apply(m);
 	return;
 }
 
-// Rotate about the origin of the coord system using a rotation matrix
 void Polygon::rotateorigin(const double angle)
 {
-	using namespace std;
-	Matrix R(cos(angle), -sin(angle), sin(angle), cos(angle));
-	for (unsigned int i{ 0 }; i < size(); i++) {
-		vertex(i) = R * vertex(i);
-	}
+	Motion m;
+	rotateorigin(m, angle);
+	apply(m);
+	return;
+}
+
+void Polygon::rotatecentre(const double angle)
+{
+	Motion m;
+	rotatecentre(m, angle);
+	apply(m);
+	return;
+}
+
+void Polygon::rescale(const double x, const double y)
+{
+	Motion m;
+	rescale(m, x, y);
+	apply(m);
+	return;
+}
+
+// Motions:
+// Composing onto the identity is exact, so a single-step motion gives just the same pose as transforming the
+// polygon directly would.
+
+void Polygon::translate(Motion& m, const Vector& r) const
+{
+	m.A = Affine::translation(r) * m.A;
+	return;
+}
+
+// Rotate about the origin of the coord system using a rotation matrix
+void Polygon::rotateorigin(Motion& m, const double angle) const
+{
+	m.A = Affine::rotation(angle) * m.A;
+	m.angle += angle;
 	return;
 }
 
 // Rotate about the centre (centroid) of the polygon. This is done in effect by translating the polygon
 // to the origin, rotating it there, and then translating back. (Equivalent to changing the basis of
 // the rotation operation: i.e. in matrix operator form: R' = T^(-1) R T; v' = R' v)
-void Polygon::rotatecentre(const double angle)
+// Affine maps take the centroid to the centroid, so after m it will be at m.A(centre()).
+void Polygon::rotatecentre(Motion& m, const double angle) const
+{
+	const Vector c{ m.A(centre()) };
+	m.A = Affine::translation(c) * Affine::rotation(angle) * Affine::translation(-c) * m.A;
+	m.angle += angle;
+	return;
+}
+
+void Polygon::apply(const Motion& m)
 {
-	Vector c = centre();
-	translate(-c); // move to origin
-	this->rotateorigin(angle); // rotate
-	translate(c); // move back
+	transform(m.A);
+	logrotation(m.angle);
 	return;
 }
 
 // Print info function
 
-void Polygon::printinfo() const
+const std::string Polygon::info() const
+{
+	std::string text;
+	appendinfo(text);
+	return text;
+}
+
+// Straight into the string, rather than through a stream
+void Polygon::appendinfo(std::string& out) const
 {
-	std::cout << this->name() << ":" << std::endl << "	";
+	out += name();
+	out += ":\n\t";
 	for (unsigned int i{ 0 }; i < size(); i++) {
-		std::cout << vertex(i) << " ";
+		append(out, vertex<access::Unchecked>(i));
+		out += ' ';
 	}
-	std::cout << std::endl;
+	out += '\n';
 	return;
 }
 
-// Derived class function definitions:
-
-void SymmetricPoly::rotateorigin(const double angle)
+void Polygon::printinfo(std::ostream& os) const
 {
-	Polygon::rotateorigin(angle);
-	orient += angle; // Same as for Polygon but also logs the change in the shape's orientation
+	const std::string text{ info() };
+	os.write(text.data(), text.size());
 	return;
 }
 
+// Derived class function definitions:
 
-void SymmetricPoly::rescale(const double width, const double height)
+// Move to the origin, remove the orientation, scale, and then put the orientation and position back:
+// S' = T R S R^(-1) T^(-1). This is composed into a single transformation.
+void SymmetricPoly::rescale(Motion& m, const double width, const double height) const
 {
-	Vector c = centre();
-	const double ori = orient;
-	Matrix S(width, 0, 0, height); // Scaling matrix diag(width, height)
-	translate(-c); // move to origin
-	rotateorigin(-ori); // remove orientation
-	for (unsigned int i{ 0 }; i < size(); i++) {
-		vertex(i) = S * vertex(i); // Apply scaling matrix to each vertex
-	}
-	rotateorigin(ori);
-	translate(c);
+	const Vector c{ m.A(centre()) };
+	const double o{ orient + m.angle };
+	m.A = Affine::translation(c) * Affine::rotation(o) * Affine::scaling(width, height)
+		* Affine::rotation(-o) * Affine::translation(-c) * m.A;
 	return;
 }
 
-// GeneralPoly constructor: equally spaces the vertices counter-clockwise on a circle centred at the origin.
-GeneralPoly::GeneralPoly(const unsigned int n, const double R) :
-	Polygon(n)
+// GeneralPoly constructor: equally spaces the vertices counter-clockwise on a circle centred at the origin,
+// with the first vertex at the top. The unit-circle vertices are shared between all n-gons (see UnitCircle.h),
+// so this is just a scaled copy.
+GeneralPoly::GeneralPoly(const unsigned int n, const double R, VertexStore* const store) :
+	Polygon(n, store)
 {
-	const double pi{ 3.14159265 };
-	const double angle = 2 * pi / size(); // Angular spacing of vertices in polar coords (rads)
-	for (unsigned int i{ 0 }; i < size(); i++) { // x = Rcos(); y = Rsin()
-		vertex(i)(1) = R * std::cos(0.5*pi + i*angle); // Add the 90 deg term in the arg so that first vertex is at the top.
-		vertex(i)(2) = R * std::sin(0.5*pi + i*angle);
-	}
+	circle::vertices(size(), R, localx(), localy());
+}
+
+GeneralPoly::GeneralPoly(const unsigned int n, const double* x, const double* y, VertexStore* const store) :
+	Polygon(n, store)
+{
+	std::copy(x, x + n, localx());
+	std::copy(y, y + n, localy());
 }
 
 // Simply rescale all vertices of the polygon. Unlike for SymmetricPoly, will change centroid of polygon.
-void GeneralPoly::rescale(const double x, const double y)
+void GeneralPoly::rescale(Motion& m, const double x, const double y) const
 {
-	Matrix S(x, 0, 0, y); // Scaling matrix diag(x,y)
-	for (unsigned int i{ 0 }; i < size(); i++) {
-		vertex(i) = S * vertex(i); // Apply scaling matrix to each vertex
-	}
+	m.A = Affine::scaling(x, y) * m.A; // Scaling matrix diag(x,y)
 }
\ No newline at end of file
@@ -6,28 +6,95 @@
 #include <memory>
 #include "Vector.h"
 #include "Matrix.h"
-
-class PolygonManager;
+#include "Affine.h"
+#include "Box.h"
+#include "VertexStore.h"
+#include "SlabIndex.h"
 
 // The abstract base class in the Polygon hierarchy.
+// A polygon doesn't own its vertices directly: it is a view onto a span of a VertexStore. Polygons made by a
+// PolygonManager share the manager's store, so that all vertices in a scene are contiguous. A polygon created
+// without a store (store = nullptr) makes a private one for itself.
+//
+// Transformations are lazy: a polygon keeps the local vertices it was built with, plus a pose - the
+// accumulated affine transformation from local to world coords. translate(), rotate...() and rescale() just
+// compose a new pose, which is O(1). The world vertices are only worked out (materialised) when something
+// actually needs them, e.g. vertex(), printinfo() or PolygonManager::draw().
+//
+// The area, centre and bounding box are cached. Area and centre are worked out once from the local vertices
+// and then mapped through the pose, so they cost O(1) however the polygon is transformed. The bounding box is
+// moved along with translations and axis scalings, and only recomputed after a rotation.
+//
+// Containment tests are done in the local frame: the points are mapped through the inverse pose, so nothing
+// needs rebuilding when the polygon is transformed. Polygons with many vertices also keep an edge-slab
+// structure over their local vertices (see SlabIndex.h) to speed the tests up.
 class Polygon {
 private:
 	const unsigned int n; // n-gon - n must be at least equal to 3 to form a polygon
-	const std::unique_ptr<Vector[]> vertices; // RAII
+	const std::unique_ptr<VertexStore> ownstore; // RAII - only used if no shared store was given
+	VertexStore* const store;
+	std::size_t offset; // Location of the first vertex in the store - only changes when the store is compacted
+
+	Affine pose; // local -> world transformation
+	mutable bool stale; // True if the world vertices in the store are out of date with the pose
+
+	// Caches
+	mutable bool localvalid; // False if the local vertices have changed since localarea, localcentre were found
+	mutable double localarea; // Signed area of the local vertices (positive if counter-clockwise)
+	mutable Vector localcentre;
+	mutable Box localbox;
+	mutable bool localconvex; // Affine maps keep convex polygons convex, so this holds in world coords too
+	mutable std::unique_ptr<SlabIndex> slabs; // Only built for polygons with at least slabThreshold vertices
+	mutable bool boxvalid;
+	mutable Box box; // World coords
+
+	static const unsigned int slabThreshold{ 64 };
+
+	[[noreturn]] static void outofrange();
+
+	void updatelocal() const; // Recompute localarea, localcentre, localbox, localconvex if needed
+
+	void bake(); // Make the current world vertices the new local vertices, and reset the pose
+
+	friend class PolygonManager; // Moves the polygons' spans when it compacts its store, and restores snapshots
+	const std::size_t storeoffset() const { return offset; }
+	void relocate(const std::size_t newoffset) { offset = newoffset; }
+	void setlocal(const double* x, const double* y, const Affine& newpose); // Replace the local vertices and pose
 
 protected:
-	// Non-const accessor protected so that derived class ctors can initialise themselves,
+	// Non-const accessors protected so that derived class ctors can initialise themselves,
 	// but access is still read-only for clients
-	Vector& vertex(const unsigned int i); // non-const accessor
+	void setvertex(const unsigned int i, const Vector& v); // Sets the position of vertex i in world coords
+	double* localx() { touch(); return store->localx() + offset; } // Start of the span of local x coords
+	double* localy() { touch(); return store->localy() + offset; }
+	void touch() { stale = true; localvalid = false; boxvalid = false; slabs.reset(); } // Invalidate everything derived from the vertices
+
+	void transform(const Affine& A); // Apply A on top of the current pose
+
+	// Called whenever the polygon has been rotated. Does nothing by default; SymmetricPoly uses it to keep
+	// track of its orientation.
+	virtual void logrotation(const double /*angle*/) {}
 
 public:
-	Polygon(const unsigned int n); // Creates a polygon with n vertices
-	virtual ~Polygon() {} // Smart pointers - clean up automatic
-	Polygon(const Polygon& poly); // Copy constructor - deep copy
+	Polygon(const unsigned int n, VertexStore* const store = nullptr); // Creates a polygon with n vertices
+	virtual ~Polygon(); // Releases its span back to the store
+	Polygon(const Polygon& poly); // Copy constructor - deep copy, into the same store as poly
 
 	Polygon& operator= (const Polygon& poly);
 
-	const Vector& vertex(const unsigned int i) const; // const accessor - read-only
+	// const accessor - read-only. Range checked according to Policy (see Access.h).
+	template<class Policy = access::Default>
+	const Vector vertex(const unsigned int i) const
+	{
+		if constexpr (Policy::checked) { if (i >= size()) { outofrange(); } }
+		materialise();
+		return Vector(store->x()[offset + i], store->y()[offset + i]);
+	}
+	const double* x() const { materialise(); return store->x() + offset; } // World coords
+	const double* y() const { materialise(); return store->y() + offset; }
+
+	const Affine& getpose() const { return pose; }
+	void materialise() const; // Bring the world vertices in the store up to date with the pose
 
 	const unsigned int size() const { return n; }
 	virtual const std::string name() const = 0; // Returns the name of the shape, e.g. "Square, 7-gon, etc"
@@ -36,17 +103,49 @@ public:
 
 	const double area() const; // Returns the area of the polygon
 
+	const Box bounds() const; // Returns the axis-aligned bounding box of the polygon
+
+	// Does the ray origin + t*direction (t >= 0) cross any of the edges? If so, t is set to the nearest crossing.
+	const bool raycast(const Vector& origin, const Vector& direction, double& t) const;
+
+	// Batch containment test (even-odd rule) of the m points x, y: inside[k] is set to whether point k is inside.
+	void contains(const double* x, const double* y, const std::size_t m, bool* inside) const;
+
+	const bool convex() const;
+
+	// Do the two polygons overlap (including just touching)? Uses the separating axis test if both are convex,
+	// otherwise checks for crossing edges and for one polygon lying inside the other.
+	const bool overlaps(const Polygon& poly) const;
+
 	void translate(const Vector& r); // Translate polygon by vector r
 	
-	virtual void rotateorigin(const double angle); // Rotate about the origin of the coord system
+	void rotateorigin(const double angle); // Rotate about the origin of the coord system
 	void rotatecentre(const double angle); // Rotate about the centre of the polygon
 	
-	virtual void rescale(const double x, const double y) = 0; // Specialised for different shape types
+	void rescale(const double x, const double y); // Specialised for different shape types (see below)
 	// E.g. a rectangle must be rescaled such that isn't skewed if it is at an angle.
 
-	void printinfo() const;
+	// A series of transformations that has been worked out but not applied yet (used by PolygonManager's
+	// transactions): the composed affine map, and the total angle it rotates by. The Motion versions of the
+	// transformations add one on top of m, working it out as if m had already been applied (e.g. rotating
+	// about where the centre would then be), and apply(m) does them all at once. The ordinary versions are
+	// just a single-step motion applied straight away.
+	struct Motion {
+		Affine A;
+		double angle;
+		Motion() : angle(0) {}
+		const bool isidentity() const { return angle == 0 && A.isidentity(); }
+	};
+	void translate(Motion& m, const Vector& r) const;
+	void rotateorigin(Motion& m, const double angle) const;
+	void rotatecentre(Motion& m, const double angle) const;
+	virtual void rescale(Motion& m, const double x, const double y) const = 0;
+	void apply(const Motion& m);
+
+	const std::string info() const; // Name and vertex list, as printed by printinfo()
+	void appendinfo(std::string& out) const; // Append info() to out
+	void printinfo(std::ostream& os = std::cout) const; // Doesn't flush
 
-	friend PolygonManager; // Not ideal, but PolygonManager::draw() required vertex access
 };
 
 // Classes derived from polygon:
@@ -60,15 +159,21 @@ private:
 	double orient; // angle of orientation (in radians)
 
 public:
-	SymmetricPoly(const unsigned int n) :
-		Polygon(n),
+	SymmetricPoly(const unsigned int n, VertexStore* const store = nullptr) :
+		Polygon(n, store),
 		orient(0)
 	{}
 	virtual ~SymmetricPoly() {} // Will also automatically call ~Polygon() to clean up.
 
 	virtual const std::string name() const = 0;
-	void rotateorigin(const double angle); // Polygon::rotatecentre() calls this, so only need to override this
-	void rescale(const double width, const double height); // Method will be the same for all derived classes.
+	using Polygon::rescale;
+	void rescale(Motion& m, const double width, const double height) const; // Method will be the same for all derived classes.
+
+	const double orientation() const { return orient; }
+	void setorientation(const double angle) { orient = angle; } // Only for restoring a saved polygon
+
+protected:
+	void logrotation(const double angle) { orient += angle; } // Polygon::rotateorigin() calls this after rotating
 };
 
 
@@ -78,9 +183,11 @@ public:
 // Pentagon, Hexagon inherit from this - the only difference being their label (i.e. name()) and default n value.
 class GeneralPoly : public Polygon {
 public:
-	GeneralPoly(const unsigned int n, const double R);
+	GeneralPoly(const unsigned int n, const double R, VertexStore* const store = nullptr);
+	GeneralPoly(const unsigned int n, const double* x, const double* y, VertexStore* const store = nullptr); // Vertices as given
 	virtual ~GeneralPoly() {}
 
 	virtual const std::string name() const { return std::to_string(size()) + "-gon"; }
-	void rescale(const double x, const double y);
+	using Polygon::rescale;
+	void rescale(Motion& m, const double x, const double y) const;
 };
\ No newline at end of file
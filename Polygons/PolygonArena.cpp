@@ -0,0 +1,84 @@
+// PolygonArena.cpp
+// Memory for polygon objects.
+
+#include <iostream>
+#include <new>
+#include "PolygonArena.h"
+
+PolygonArena::PolygonArena() :
+	cursor(nullptr),
+	limit(nullptr),
+	counters{ 0, 0, 0, 0, 0, 0 }
+{
+	for (std::size_t c{ 0 }; c < classes; c++) { freelists[c] = nullptr; }
+}
+
+void* PolygonArena::newblock(const std::size_t bytes)
+{
+	const std::size_t size{ bytes > blockSize ? bytes : blockSize };
+	try { blocks.emplace_back(new char[size]); } // new char[] is suitably aligned for any type
+	catch (std::bad_alloc memfail)
+	{
+		std::cerr << "Error: Could not allocate memory for polygons." << std::endl;
+		exit(1);
+	}
+	counters.blocks++;
+	counters.bytes += size;
+	return blocks.back().get();
+}
+
+// The size class c holds objects of up to (c + 1) * granule bytes, header included. Objects too large for
+// any class get a block to themselves (this shouldn't happen for the shapes in this program).
+void* PolygonArena::allocate(const std::size_t size)
+{
+	const std::size_t total{ size + sizeof(Header) };
+	const std::size_t c{ (total - 1) / granule };
+	counters.allocations++;
+	counters.live++;
+
+	char* memory;
+	if (c >= classes) { memory = static_cast<char*>(newblock(total)); }
+	else if (freelists[c] != nullptr) {
+		memory = reinterpret_cast<char*>(freelists[c]);
+		freelists[c] = freelists[c]->next;
+		counters.reused++;
+	}
+	else {
+		const std::size_t rounded{ (c + 1) * granule };
+		if (cursor == nullptr || static_cast<std::size_t>(limit - cursor) < rounded) {
+			cursor = static_cast<char*>(newblock(blockSize));
+			limit = cursor + blockSize;
+		}
+		memory = cursor;
+		cursor += rounded;
+	}
+	reinterpret_cast<Header*>(memory)->sizeclass = c;
+	return memory + sizeof(Header);
+}
+
+// Large objects' blocks are only given back by reset()
+void PolygonArena::deallocate(void* const p)
+{
+	if (p == nullptr) { return; }
+	char* const memory{ static_cast<char*>(p) - sizeof(Header) };
+	const std::size_t c{ reinterpret_cast<Header*>(memory)->sizeclass };
+	counters.frees++;
+	counters.live--;
+	if (c >= classes) { return; }
+	FreeNode* const node{ reinterpret_cast<FreeNode*>(memory) };
+	node->next = freelists[c];
+	freelists[c] = node;
+	return;
+}
+
+void PolygonArena::reset()
+{
+	blocks.clear();
+	cursor = limit = nullptr;
+	for (std::size_t c{ 0 }; c < classes; c++) { freelists[c] = nullptr; }
+	counters.frees += counters.live;
+	counters.live = 0;
+	counters.blocks = 0;
+	counters.bytes = 0;
+	return;
+}
\ No newline at end of file
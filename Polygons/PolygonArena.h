@@ -0,0 +1,63 @@
+// PolygonArena.h
+// Memory for polygon objects, so that building a large scene doesn't make one heap allocation per shape.
+// Objects are carved out of large blocks with a bump pointer. Freed objects are kept on a free list for their
+// size class (multiples of 16 bytes) and are reused before the bump pointer moves on. Everything can be given
+// back in one go with reset().
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+class PolygonArena {
+public:
+	// Allocation counters
+	struct Stats {
+		std::size_t allocations; // Objects allocated in total
+		std::size_t frees;
+		std::size_t reused; // Allocations served from a free list
+		std::size_t blocks; // Blocks currently held
+		std::size_t bytes; // Bytes currently held in blocks
+		std::size_t live; // Objects currently allocated
+	};
+
+private:
+	static const std::size_t blockSize{ 1 << 16 };
+	static const std::size_t granule{ 16 }; // Alignment and size class step
+	static const std::size_t classes{ 32 }; // Up to 512 bytes (including the header); larger objects use the heap
+
+	// Each object is preceded by a header recording its size class, so deallocate() only needs the pointer
+	union Header {
+		std::size_t sizeclass;
+		char pad[granule];
+	};
+	struct FreeNode { FreeNode* next; };
+
+	std::vector<std::unique_ptr<char[]> > blocks;
+	char* cursor; // Next free byte in the current block
+	char* limit; // End of the current block
+	FreeNode* freelists[classes];
+	Stats counters;
+
+	void* newblock(const std::size_t bytes); // Start a new block, with room for at least bytes
+
+public:
+	PolygonArena();
+	~PolygonArena() {}
+	PolygonArena(const PolygonArena&) = delete;
+	PolygonArena& operator= (const PolygonArena&) = delete;
+
+	void* allocate(const std::size_t size);
+	void deallocate(void* const p);
+
+	// Run the destructor of an object made with placement new on allocate(), and free its memory
+	template<class T>
+	void destroy(T* const p) {
+		p->~T();
+		deallocate(p);
+	}
+
+	void reset(); // Release all the blocks at once. Any objects still in them must already have been destroyed.
+
+	const Stats& stats() const { return counters; }
+};
\ No newline at end of file
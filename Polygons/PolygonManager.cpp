@@ -2,8 +2,32 @@
 // A class for storing and managing all the polygons used in the program.
 
 #include "Derived shapes.h"
+#include <algorithm>
 #include "PolygonManager.h"
 
+PolygonManager::PolygonManager(const unsigned int threads) :
+	vertextotal(0),
+	drawWidth(79),
+	drawHeight(0),
+	frameScale(0),
+	pool(new ThreadPool(threads)),
+	parallelCutoff(2048),
+	transaction(false),
+	pendingall(false)
+{}
+
+const double PolygonManager::getarea(const unsigned int i) const
+{
+	const CommandStats::Scope scope(commandstats, CommandStats::area);
+	return polygon(i)->area();
+}
+
+void PolygonManager::setthreads(const unsigned int threads)
+{
+	pool.reset(new ThreadPool(threads));
+	return;
+}
+
 // Polygon accessor:
 // Starts at i = 1,...,count
 Polygon* PolygonManager::polygon(const unsigned int i) const
@@ -19,140 +43,596 @@ Polygon* PolygonManager::polygon(const unsigned int i) const
 
 PolygonManager::~PolygonManager()
 {
-	if (!polygons.empty()) 
-	{
-		for (auto it = polygons.begin(); it != polygons.end(); it++) 
-		{
-			delete *it;
-		}
-		polygons.clear();
-	}
+	clear();
+}
+
+void PolygonManager::reserve(const std::size_t shapes, const std::size_t vertices)
+{
+	polygons.reserve(shapes);
+	handles.reserve(shapes);
+	store.reserve(vertices);
+	return;
+}
+
+// The polygons are destroyed last to first, so that each one's vertices are at the end of the store and are
+// just trimmed off rather than zeroed. Then the arena's blocks and the store are released in one go.
+void PolygonManager::clear()
+{
+	const CommandStats::Scope scope(commandstats, CommandStats::clear);
+	for (auto it = polygons.rbegin(); it != polygons.rend(); it++) { arena.destroy(*it); }
+	polygons.clear();
+	vertextotal = 0;
+	handles.clear();
+	arena.reset();
+	store.clear();
+	proxies.clear();
+	if (index) { index->clear(); }
+	dirty.clear();
+	drawn.clear();
+	erased.clear();
+	frameScale = 0;
+	pending.clear();
+	return;
 }
 
 // Function to display a list of the polygons and their info
-void PolygonManager::listshapes() const
+void PolygonManager::listshapes(std::ostream& os) const
 {
-	unsigned int i{ 1 };
-	for (auto it = polygons.cbegin(); it != polygons.cend(); it++, i++) {
-		std::cout << "	" << i << ". " << (*it)->name() << std::endl;
+	const CommandStats::Scope scope(commandstats, CommandStats::list);
+	std::string text;
+	text.reserve(24 * polygons.size());
+	for (std::size_t i{ 0 }; i < polygons.size(); i++) {
+		text += '\t';
+		text += std::to_string(i + 1);
+		text += ". ";
+		text += polygons[i]->name();
+		text += '\n';
 	}
+	os.write(text.data(), text.size());
 }
 
-void PolygonManager::listinfo() const
+// The text for each chunk of polygons is put together in parallel, then joined up in order
+void PolygonManager::listinfo(std::ostream& os) const
 {
-	unsigned int i{ 1 };
-	for (auto it = polygons.cbegin(); it != polygons.cend(); it++, i++) {
-		std::cout << i << ". ";
-		(*it)->printinfo();
-	}
+	const CommandStats::Scope scope(commandstats, CommandStats::list);
+	commandstats.processed(vertextotal);
+	std::vector<std::string> chunks((polygons.size() + grain - 1) / grain);
+	forchunks([&](const std::size_t begin, const std::size_t end) {
+		for (std::size_t first{ begin }; first < end; first += grain) { // forchunks() may do everything at once
+			std::string& text{ chunks[first / grain] };
+			for (std::size_t i{ first }; i < end && i < first + grain; i++) {
+				text += std::to_string(i + 1);
+				text += ". ";
+				polygons[i]->appendinfo(text);
+			}
+		}
+	});
+	std::size_t total{ 0 };
+	for (auto it = chunks.cbegin(); it != chunks.cend(); it++) { total += it->size(); }
+	std::string text;
+	text.reserve(total);
+	for (auto it = chunks.cbegin(); it != chunks.cend(); it++) { text += *it; }
+	os.write(text.data(), text.size());
 }
 
 // Functions to add polygons:
 // Note: factory functions (declared in Derived shapes.h using namespace fact) take care of bad_alloc exception handling.
 
-void PolygonManager::addisos(const double base, const double height)
+const PolygonManager::Handle PolygonManager::add(Polygon* const poly)
 {
-	polygons.push_back(fact::createIsosceles(base, height));
-	return;
+	polygons.push_back(poly);
+	vertextotal += poly->size();
+	commandstats.processed(poly->size());
+	dirty.push_back(1);
+	drawn.push_back(Framebuffer::Region{ 0, 0, -1, -1 }); // Not drawn yet
+	if (transaction) { pending.push_back(Polygon::Motion()); }
+	if (index) { proxies.push_back(index->insert(poly->bounds(), (unsigned int)polygons.size() - 1)); }
+	return handles.insert();
 }
 
-void PolygonManager::addrect(const double width, const double height)
+const PolygonManager::Handle PolygonManager::addisos(const double base, const double height)
 {
-	polygons.push_back(fact::createRectangle(width, height));
-	return;
+	const CommandStats::Scope scope(commandstats, CommandStats::add);
+	return add(fact::createIsosceles(base, height, &store, &arena));
 }
 
-void PolygonManager::addpenta(const double R)
+const PolygonManager::Handle PolygonManager::addrect(const double width, const double height)
 {
-	polygons.push_back(fact::createPentagon(R));
-	return;
+	const CommandStats::Scope scope(commandstats, CommandStats::add);
+	return add(fact::createRectangle(width, height, &store, &arena));
 }
 
-void PolygonManager::addhexa(const double R)
+const PolygonManager::Handle PolygonManager::addpenta(const double R)
 {
-	polygons.push_back(fact::createHexagon(R));
+	const CommandStats::Scope scope(commandstats, CommandStats::add);
+	return add(fact::createPentagon(R, &store, &arena));
+}
+
+const PolygonManager::Handle PolygonManager::addhexa(const double R)
+{
+	const CommandStats::Scope scope(commandstats, CommandStats::add);
+	return add(fact::createHexagon(R, &store, &arena));
+}
+
+const PolygonManager::Handle PolygonManager::addngon(const unsigned int n, const double R)
+{
+	const CommandStats::Scope scope(commandstats, CommandStats::add);
+	return add(fact::createGenPoly(n, R, &store, &arena));
+}
+
+// Handles:
+
+const PolygonManager::Handle PolygonManager::handle(const unsigned int i) const
+{
+	polygon(i); // Range check
+	return handles.handle(i - 1);
+}
+
+const unsigned int PolygonManager::position(const Handle h) const
+{
+	if (!handles.valid(h)) {
+		std::cerr << "Error: Attempted to use the handle of a polygon that has been removed." << std::endl;
+		exit(1);
+	}
+	return (unsigned int)handles.position(h) + 1;
+}
+
+// Removing functions:
+// The last polygon in the list takes the place of the removed one (along with its leaf in the index), so
+// removal is O(1).
+
+void PolygonManager::remove(const unsigned int i)
+{
+	const CommandStats::Scope scope(commandstats, CommandStats::remove);
+	remove(handle(i));
 	return;
 }
 
-void PolygonManager::addngon(const unsigned int n, const double R)
+void PolygonManager::remove(const Handle h)
 {
-	polygons.push_back(fact::createGenPoly(n, R));
+	const CommandStats::Scope scope(commandstats, CommandStats::remove);
+	position(h); // Check h is still valid
+	const std::size_t i{ handles.erase(h) };
+	Polygon* const poly{ polygons[i] };
+	vertextotal -= poly->size();
+	commandstats.processed(poly->size());
+	polygons[i] = polygons.back();
+	polygons.pop_back();
+	erased.push_back(drawn[i]);
+	dirty[i] = dirty.back();
+	dirty.pop_back();
+	drawn[i] = drawn.back();
+	drawn.pop_back();
+	if (transaction) {
+		pending[i] = pending.back();
+		pending.pop_back();
+	}
+	if (index) {
+		index->remove(proxies[i]);
+		proxies[i] = proxies.back();
+		proxies.pop_back();
+		if (i < proxies.size()) { index->setkey(proxies[i], (unsigned int)i); }
+	}
+	arena.destroy(poly);
 	return;
 }
 
-// Removing function:
-void PolygonManager::remove(const unsigned int i)
+// Lay the vertices out again in list order, so the store has no holes and each polygon's vertices follow
+// those of the polygon before it
+void PolygonManager::compact()
 {
-	unsigned int j{ 1 };
-	auto it = polygons.cbegin(); // Increment const_iterator i times
-	while (j < i) {
-		it++; j++;
+	const CommandStats::Scope scope(commandstats, CommandStats::compact);
+	commandstats.processed(vertextotal);
+	std::vector<std::size_t> offsets(polygons.size());
+	std::vector<unsigned int> counts(polygons.size());
+	for (std::size_t i{ 0 }; i < polygons.size(); i++) {
+		offsets[i] = polygons[i]->storeoffset();
+		counts[i] = polygons[i]->size();
 	}
-	polygons.erase(it);
+	store.compact(offsets, counts);
+	for (std::size_t i{ 0 }; i < polygons.size(); i++) { polygons[i]->relocate(offsets[i]); }
 	return;
 }
 
 
-//
+// Transformations to single polygons:
+// If the spatial index is on, the polygon's leaf is refitted afterwards. In a transaction, they are only
+// added to the polygon's pending motion.
 
 void PolygonManager::translate(const unsigned int i, const Vector& r)
 {
+	const CommandStats::Scope scope(commandstats, CommandStats::move);
+	if (transaction) {
+		polygon(i)->translate(pending[i - 1], r);
+		return;
+	}
+	commandstats.processed(polygon(i)->size());
 	polygon(i)->translate(r);
+	refit(i);
+	dirty[i - 1] = 1;
 	return;
 }
 
 void PolygonManager::rotate(const unsigned int i, const double angle)
 {
+	const CommandStats::Scope scope(commandstats, CommandStats::rotate);
+	if (transaction) {
+		polygon(i)->rotatecentre(pending[i - 1], angle);
+		return;
+	}
+	commandstats.processed(polygon(i)->size());
 	polygon(i)->rotatecentre(angle);
+	refit(i);
+	dirty[i - 1] = 1;
 	return;
 }
 
 void PolygonManager::rescale(const unsigned int i, const double x, const double y)
 {
+	const CommandStats::Scope scope(commandstats, CommandStats::rescale);
+	if (transaction) {
+		polygon(i)->rescale(pending[i - 1], x, y);
+		return;
+	}
+	commandstats.processed(polygon(i)->size());
 	polygon(i)->rescale(x, y);
+	refit(i);
+	dirty[i - 1] = 1;
 	return;
 }
 
 // Transformations to all polygons:
+// These only compose each polygon's pose (see Polygon.h), so they never touch the vertices themselves.
+// A translation moves the spatial index along with it; anything else means the index is rebuilt.
+// In a transaction, they are added to every polygon's pending motion instead.
 
 void PolygonManager::translateall(const Vector& r)
 {
-	for (auto it = polygons.begin(); it != polygons.end(); it++) {
-		(*it)->translate(r);
+	const CommandStats::Scope scope(commandstats, CommandStats::move);
+	if (transaction) {
+		forchunks([&](const std::size_t begin, const std::size_t end) {
+			for (std::size_t i{ begin }; i < end; i++) { polygons[i]->translate(pending[i], r); }
+		});
+		pendingall = true;
+		return;
 	}
+	commandstats.processed(vertextotal);
+	forall([&](Polygon* poly) { poly->translate(r); });
+	if (index) { index->shift(r); }
+	frameScale = 0;
 	return;
 }
 
 void PolygonManager::rotateall(const double angle)
 {
-	for (auto it = polygons.begin(); it != polygons.end(); it++) {
-		(*it)->rotateorigin(angle);
+	const CommandStats::Scope scope(commandstats, CommandStats::rotate);
+	if (transaction) {
+		forchunks([&](const std::size_t begin, const std::size_t end) {
+			for (std::size_t i{ begin }; i < end; i++) { polygons[i]->rotateorigin(pending[i], angle); }
+		});
+		pendingall = true;
+		return;
 	}
+	commandstats.processed(vertextotal);
+	forall([&](Polygon* poly) { poly->rotateorigin(angle); });
+	rebuildindex();
+	frameScale = 0;
 	return;
 }
 
 void PolygonManager::rescaleall(const double x, const double y)
 {
+	const CommandStats::Scope scope(commandstats, CommandStats::rescale);
 	// May not behave as expected, since rescale() works differently for different polygons
-	for (auto it = polygons.begin(); it != polygons.end(); it++) {
-		(*it)->rescale(x, y);
+	if (transaction) {
+		forchunks([&](const std::size_t begin, const std::size_t end) {
+			for (std::size_t i{ begin }; i < end; i++) { polygons[i]->rescale(pending[i], x, y); }
+		});
+		pendingall = true;
+		return;
 	}
+	commandstats.processed(vertextotal);
+	forall([&](Polygon* poly) { poly->rescale(x, y); });
+	rebuildindex();
+	frameScale = 0;
 	return;
 }
 
+// The sum of the centres is a parallel reduction; it is deterministic, so the result doesn't depend on the
+// number of threads. In a transaction, the centres are where the pending motions would take them.
 void PolygonManager::centreall()
 {
+	const CommandStats::Scope scope(commandstats, CommandStats::centre);
+	if (polygons.empty()) { return; }
+	const auto sumchunk = [this](const std::size_t begin, const std::size_t end) {
+		Vector sum;
+		for (std::size_t i{ begin }; i < end; i++) {
+			sum += transaction ? pending[i].A(polygons[i]->centre()) : polygons[i]->centre();
+		}
+		return sum;
+	};
+	const auto add = [](const Vector& a, const Vector& b) { return a + b; };
 	Vector sumcentres;
-	for (auto it = polygons.begin(); it != polygons.end(); it++) {
-		sumcentres += (*it)->centre();
-	}
+	if (polygons.size() < parallelCutoff) { sumcentres = sumchunk(0, polygons.size()); }
+	else { sumcentres = pool->reduce(polygons.size(), grain, Vector(), sumchunk, add); }
 	Vector c{ (1.0 / count())*sumcentres };
 	translateall(-c);
 	return;
 }
 
+// Transactions:
+
+const bool PolygonManager::begin()
+{
+	if (transaction) { return false; }
+	transaction = true;
+	pendingall = false;
+	pending.assign(polygons.size(), Polygon::Motion());
+	return true;
+}
+
+// Each polygon with a pending motion has it composed into its pose and is marked for redrawing; like the
+// ordinary transformations, this doesn't touch the vertices, which are worked out the next time they are
+// needed. Then the spatial index is brought up to date in one go: refitting just the moved polygons, or
+// rebuilding it if the whole scene was transformed.
+const bool PolygonManager::commit()
+{
+	const CommandStats::Scope scope(commandstats, CommandStats::commit);
+	if (!transaction) { return false; }
+	transaction = false;
+	const auto applychunk = [this](const std::size_t begin, const std::size_t end) {
+		std::size_t vertices{ 0 };
+		for (std::size_t i{ begin }; i < end; i++) {
+			if (pending[i].isidentity()) { continue; }
+			polygons[i]->apply(pending[i]);
+			dirty[i] = 1;
+			vertices += polygons[i]->size();
+		}
+		return vertices;
+	};
+	const auto add = [](const std::size_t a, const std::size_t b) { return a + b; };
+	if (polygons.size() < parallelCutoff) { commandstats.processed(applychunk(0, polygons.size())); }
+	else { commandstats.processed(pool->reduce(polygons.size(), grain, std::size_t(0), applychunk, add)); }
+
+	if (pendingall) {
+		rebuildindex();
+		frameScale = 0;
+	}
+	else if (index) {
+		for (std::size_t i{ 0 }; i < polygons.size(); i++) {
+			if (!pending[i].isidentity()) { refit((unsigned int)i + 1); }
+		}
+	}
+	pending.clear();
+	return true;
+}
+
+const Box PolygonManager::extents() const
+{
+	if (polygons.empty()) { return Box(); }
+	const auto boxchunk = [this](const std::size_t begin, const std::size_t end) {
+		Box box{ polygons[begin]->bounds() };
+		for (std::size_t i{ begin + 1 }; i < end; i++) { box = box.merge(polygons[i]->bounds()); }
+		return box;
+	};
+	const auto merge = [](const Box& a, const Box& b) { return a.merge(b); };
+	if (polygons.size() < parallelCutoff) { return boxchunk(0, polygons.size()); }
+	const Box first{ polygons[0]->bounds() }; // Identity for the reduction: merging with it changes nothing
+	return pool->reduce(polygons.size(), grain, first, boxchunk, merge);
+}
+
+// Spatial index functions:
+
+void PolygonManager::setindexing(const bool on)
+{
+	if (!on) {
+		index.reset();
+		proxies.clear();
+		return;
+	}
+	if (!index) { index.reset(new AABBTree); }
+	rebuildindex();
+	return;
+}
+
+// The polygons' bounding boxes are found in parallel (this may mean materialising their vertices), then the
+// tree is built from them in one go
+void PolygonManager::rebuildindex()
+{
+	if (!index) { return; }
+	std::vector<Box> boxes(polygons.size());
+	forchunks([&](const std::size_t begin, const std::size_t end) {
+		for (std::size_t i{ begin }; i < end; i++) { boxes[i] = polygons[i]->bounds(); }
+	});
+	index->build(boxes, proxies);
+	return;
+}
+
+void PolygonManager::refit(const unsigned int i)
+{
+	if (index) { index->update(proxies[i - 1], polygon(i)->bounds()); }
+	return;
+}
+
+// Polygons (1,...,count) whose bounding boxes overlap the region, in order. The tree's leaf boxes are
+// slightly enlarged, so its results are checked against the actual bounding boxes.
+const std::vector<unsigned int> PolygonManager::query(const Box& region) const
+{
+	const CommandStats::Scope scope(commandstats, CommandStats::query);
+	std::vector<unsigned int> found;
+	if (index) {
+		std::vector<unsigned int> keys;
+		index->query(region, keys);
+		for (auto it = keys.cbegin(); it != keys.cend(); it++) {
+			if (polygons[*it]->bounds().overlaps(region)) { found.push_back(*it + 1); }
+		}
+		std::sort(found.begin(), found.end());
+	}
+	else {
+		for (std::size_t i{ 0 }; i < polygons.size(); i++) {
+			if (polygons[i]->bounds().overlaps(region)) { found.push_back((unsigned int)i + 1); }
+		}
+	}
+	return found;
+}
+
+// Polygons (1,...,count) whose edges are hit by the ray origin + t*direction (t >= 0), nearest first
+const std::vector<unsigned int> PolygonManager::raycast(const Vector& origin, const Vector& direction) const
+{
+	const CommandStats::Scope scope(commandstats, CommandStats::query);
+	std::vector<unsigned int> candidates;
+	if (index) { index->raycast(origin, direction, candidates); }
+	else {
+		for (std::size_t i{ 0 }; i < polygons.size(); i++) { candidates.push_back((unsigned int)i); }
+	}
+
+	std::vector<std::pair<double, unsigned int> > hits;
+	for (auto it = candidates.cbegin(); it != candidates.cend(); it++) {
+		double t;
+		if (polygons[*it]->raycast(origin, direction, t)) { hits.push_back(std::make_pair(t, *it + 1)); }
+	}
+	std::sort(hits.begin(), hits.end());
+
+	std::vector<unsigned int> found;
+	for (auto it = hits.cbegin(); it != hits.cend(); it++) { found.push_back(it->second); }
+	return found;
+}
+
+// Which polygons contain each of the m points x, y. First each polygon gets a list of candidate points: those
+// in its bounding box. With the index this is done by looking up each point in the tree (in parallel, over
+// chunks of points); without it, each polygon checks every point against its box. Then each polygon tests all
+// of its candidates in one batch, and finally the results are gathered by point.
+const PolygonManager::Containment PolygonManager::contains(const double* x, const double* y, const std::size_t m) const
+{
+	const CommandStats::Scope scope(commandstats, CommandStats::query);
+	std::vector<std::vector<std::size_t> > candidates(polygons.size()); // Points, in increasing order
+	if (index) {
+		const std::size_t pointgrain{ 4096 };
+		std::vector<std::vector<std::pair<unsigned int, std::size_t> > > pairs((m + pointgrain - 1) / pointgrain);
+		pool->parallelfor(m, pointgrain, [&](const std::size_t begin, const std::size_t end) {
+			std::vector<std::pair<unsigned int, std::size_t> >& found{ pairs[begin / pointgrain] };
+			std::vector<unsigned int> keys;
+			std::vector<int> stack; // Shared by the chunk's lookups
+			stack.reserve(64);
+			for (std::size_t k{ begin }; k < end; k++) {
+				const Vector p(x[k], y[k]);
+				keys.clear();
+				index->query(Box(p, p), keys, stack);
+				for (auto it = keys.cbegin(); it != keys.cend(); it++) { found.push_back(std::make_pair(*it, k)); }
+			}
+		});
+		for (auto chunk = pairs.cbegin(); chunk != pairs.cend(); chunk++) {
+			for (auto it = chunk->cbegin(); it != chunk->cend(); it++) { candidates[it->first].push_back(it->second); }
+		}
+	}
+	else {
+		forchunks([&](const std::size_t begin, const std::size_t end) {
+			for (std::size_t i{ begin }; i < end; i++) {
+				const Box box{ polygons[i]->bounds() };
+				const double minx{ box.min.getx() }, miny{ box.min.gety() }, maxx{ box.max.getx() }, maxy{ box.max.gety() };
+				for (std::size_t k{ 0 }; k < m; k++) {
+					if ((x[k] >= minx) & (x[k] <= maxx) & (y[k] >= miny) & (y[k] <= maxy)) { candidates[i].push_back(k); }
+				}
+			}
+		});
+	}
+
+	// Batch test, keeping only the candidates that are inside
+	forchunks([&](const std::size_t begin, const std::size_t end) {
+		std::vector<double> px, py;
+		std::unique_ptr<bool[]> inside;
+		std::size_t room{ 0 };
+		for (std::size_t i{ begin }; i < end; i++) {
+			std::vector<std::size_t>& points{ candidates[i] };
+			const std::size_t n{ points.size() };
+			if (n == 0) { continue; }
+			px.resize(n);
+			py.resize(n);
+			if (n > room) {
+				inside.reset(new bool[n]);
+				room = n;
+			}
+			for (std::size_t k{ 0 }; k < n; k++) {
+				px[k] = x[points[k]];
+				py[k] = y[points[k]];
+			}
+			polygons[i]->contains(px.data(), py.data(), n, inside.get());
+			std::size_t kept{ 0 };
+			for (std::size_t k{ 0 }; k < n; k++) {
+				points[kept] = points[k];
+				kept += inside[k] ? 1 : 0;
+			}
+			points.resize(kept);
+		}
+	});
+
+	// Counting sort by point. Going through the polygons in order leaves each point's list sorted.
+	Containment result;
+	result.first.assign(m + 1, 0);
+	for (auto it = candidates.cbegin(); it != candidates.cend(); it++) {
+		for (auto k = it->cbegin(); k != it->cend(); k++) { result.first[*k + 1]++; }
+	}
+	for (std::size_t k{ 0 }; k < m; k++) { result.first[k + 1] += result.first[k]; }
+	result.hits.resize(result.first[m]);
+	std::vector<std::size_t> next(result.first.begin(), result.first.end() - 1);
+	for (std::size_t i{ 0 }; i < candidates.size(); i++) {
+		for (auto k = candidates[i].cbegin(); k != candidates[i].cend(); k++) {
+			result.hits[next[*k]++] = (unsigned int)i + 1;
+		}
+	}
+	return result;
+}
+
+// Broad phase: sweep and prune. The boxes are sorted by their left edges; each box is then paired with the
+// boxes after it in that order, up to the first one starting to the right of it, and those that overlap in y
+// too go on to the narrow phase (Polygon::overlaps()). The sweep is split over the thread pool, so every
+// polygon is brought fully up to date first - after that the narrow phase only reads from them.
+const std::vector<std::pair<unsigned int, unsigned int> > PolygonManager::collisions() const
+{
+	const CommandStats::Scope scope(commandstats, CommandStats::query);
+	commandstats.processed(vertextotal);
+	typedef std::pair<unsigned int, unsigned int> Pair;
+	std::vector<Box> boxes(polygons.size());
+	forchunks([&](const std::size_t begin, const std::size_t end) {
+		for (std::size_t i{ begin }; i < end; i++) {
+			polygons[i]->materialise();
+			polygons[i]->convex();
+			boxes[i] = polygons[i]->bounds();
+		}
+	});
+
+	std::vector<std::pair<double, unsigned int> > sweep(polygons.size()); // (left edge, polygon)
+	for (std::size_t i{ 0 }; i < polygons.size(); i++) { sweep[i] = std::make_pair(boxes[i].min.getx(), (unsigned int)i); }
+	std::sort(sweep.begin(), sweep.end());
+
+	std::vector<std::vector<Pair> > found((polygons.size() + grain - 1) / grain); // Per chunk of the sweep
+	forchunks([&](const std::size_t begin, const std::size_t end) {
+		std::vector<Pair>& pairs{ found[begin / grain] };
+		for (std::size_t p{ begin }; p < end; p++) {
+			const unsigned int i{ sweep[p].second };
+			const Box& a{ boxes[i] };
+			for (std::size_t q{ p + 1 }; q < sweep.size() && sweep[q].first <= a.max.getx(); q++) {
+				const unsigned int j{ sweep[q].second };
+				if (!a.overlaps(boxes[j]) || !polygons[i]->overlaps(*polygons[j])) { continue; }
+				pairs.push_back(i < j ? Pair(i + 1, j + 1) : Pair(j + 1, i + 1));
+			}
+		}
+	});
+
+	std::vector<Pair> result;
+	for (auto it = found.cbegin(); it != found.cend(); it++) { result.insert(result.end(), it->cbegin(), it->cend()); }
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
 void PolygonManager::setdrawWidth(const unsigned int width)
 {
-	drawWidth = width;
+	drawWidth = (width < maxDrawSize) ? width : maxDrawSize;
+	return;
+}
+
+void PolygonManager::setdrawHeight(const unsigned int height)
+{
+	drawHeight = (height < maxDrawSize) ? height : maxDrawSize;
 	return;
 }
\ No newline at end of file
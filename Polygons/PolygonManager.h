@@ -4,35 +4,121 @@
 #pragma once
 
 #include <vector>
+#include <memory>
 #include "Polygon.h"
+#include "PolygonArena.h"
+#include "SlotMap.h"
+#include "ThreadPool.h"
+#include "AABBTree.h"
+#include "CommandStats.h"
+#include "Framebuffer.h"
 
 class PolygonManager {
 private:
-	std::vector<Polygon*> polygons;
+	VertexStore store; // All the polygons' vertices, stored contiguously. Declared first so it outlives them.
+	PolygonArena arena; // The polygon objects themselves
+	std::vector<Polygon*> polygons; // Dense - removal moves the last polygon into the gap
+	SlotMap handles; // Handle -> position in polygons
+	std::size_t vertextotal; // Vertices in all the polygons
 	
 	Polygon* polygon(const unsigned int i) const; // Polygon accessor - does range checking
 
+	mutable CommandStats commandstats; // Every public operation is timed (see CommandStats.h)
+
 	unsigned int drawWidth; // Used by draw() - default value is 79.
+	unsigned int drawHeight; // 0 (the default) for half the width, since console characters are about twice as tall as they are wide
+
+	// draw() keeps its last image, and next time only redraws the parts that have changed (see Draw.cpp).
+	// dirty[i] and drawn[i] go with polygon i + 1.
+	mutable Framebuffer frame;
+	mutable double frameScale; // Scale frame was drawn at, or 0 if it has to be drawn from scratch
+	mutable std::vector<char> dirty; // Polygon changed since the last draw
+	mutable std::vector<Framebuffer::Region> drawn; // Where the polygon was in the last draw
+	mutable std::vector<Framebuffer::Region> erased; // Where removed polygons were in the last draw
+
+	// Scene-wide operations are split across a thread pool, unless there are fewer than parallelCutoff polygons.
+	std::unique_ptr<ThreadPool> pool;
+	std::size_t parallelCutoff;
+	static const std::size_t grain{ 256 }; // Polygons per chunk of work
+
+	// Open transaction (see begin()): pending[i] is the motion waiting to be applied to polygon i + 1
+	bool transaction;
+	std::vector<Polygon::Motion> pending;
+	bool pendingall; // Some of the pending motions came from scene-wide transformations
+
+	// Optional spatial index over the polygons' bounding boxes. The key of each leaf is the polygon's position
+	// in the list (from 0), and proxies[i] is the leaf for polygon i + 1.
+	std::unique_ptr<AABBTree> index;
+	std::vector<int> proxies;
+
+	const SlotMap::Handle add(Polygon* const poly); // Add a newly created polygon to the list (and the index)
+	void rebuildindex();
+	void refit(const unsigned int i); // Update polygon i's leaf after it has been transformed
+
+	template<class Body>
+	void forchunks(const Body& body) const; // Call body(begin, end) over chunks of the polygon list
+	template<class Body>
+	void forall(const Body& body) const; // Call body(Polygon*) for every polygon
 
 public:
-	PolygonManager() : drawWidth(79) {}
+	// Result of contains(): the polygons containing point k are hits[first[k]],...,hits[first[k + 1] - 1],
+	// as positions in the list in increasing order
+	struct Containment {
+		std::vector<std::size_t> first;
+		std::vector<unsigned int> hits;
+	};
+
+	PolygonManager(const unsigned int threads = 0); // threads = 0: one per hardware thread
 	~PolygonManager();
 
+	void setthreads(const unsigned int threads);
+	void setparallelcutoff(const std::size_t cutoff) { parallelCutoff = cutoff; }
+	const unsigned int threadcount() const { return pool->size(); }
+
 	const int count() const { return polygons.size(); }
+	const std::size_t vertexcount() const { return vertextotal; }
+	CommandStats& stats() const { return commandstats; }
 
-	void listshapes() const;
-	void listinfo() const;
+	void reserve(const std::size_t shapes, const std::size_t vertices); // Make room before a bulk load
+	void clear(); // Remove every polygon at once
+	const PolygonArena::Stats& allocstats() const { return arena.stats(); }
+
+	// Listings and draw() are put together in one buffer and written to os in one go. They don't flush os -
+	// that's up to the caller.
+	void listshapes(std::ostream& os = std::cout) const;
+	void listinfo(std::ostream& os = std::cout) const;
 
 	const std::string getname(const unsigned int i) const { return polygon(i)->name(); }
-	const double getarea(const unsigned int i) const { return polygon(i)->area(); }
+	const double getarea(const unsigned int i) const;
+
+	// Polygons can be referred to either by their position in the list (1,...,count), or by a handle. Removing
+	// a polygon moves the last one in the list into its place, but handles always refer to the same polygon.
+	typedef SlotMap::Handle Handle;
+	const Handle handle(const unsigned int i) const;
+	const bool valid(const Handle h) const { return handles.valid(h); } // False once the polygon is removed
+	const unsigned int position(const Handle h) const; // Current position of a polygon in the list
 
-	void addisos(const double base, const double height);
-	void addrect(const double width, const double height);
-	void addpenta(const double R); // circumradius R
-	void addhexa(const double R);
-	void addngon(const unsigned int n, const double R); // Add a general (initially regular) n-gon, with circumradius R
+	const Handle addisos(const double base, const double height);
+	const Handle addrect(const double width, const double height);
+	const Handle addpenta(const double R); // circumradius R
+	const Handle addhexa(const double R);
+	const Handle addngon(const unsigned int n, const double R); // Add a general (initially regular) n-gon, with circumradius R
 
 	void remove(const unsigned int i); // Remove the ith pgon in the list
+	void remove(const Handle h);
+
+	void compact(); // Close up the gaps that removals have left in the vertex store
+
+	// Binary snapshots of the whole scene (see Snapshot.h). load() replaces the current scene. Both report any
+	// problem to std::cerr and return false.
+	const bool save(const char* const path) const;
+	const bool load(const char* const path);
+
+	// Polygons as text, one per line in WKT or one vertex per line in CSV (see TextIO.cpp). Imported polygons are
+	// added to the scene as general polygons, with their vertices as given; export writes the world coords.
+	enum TextFormat { wkt, csv };
+	const bool importtext(const char* const path, const TextFormat format);
+	const bool exporttext(const char* const path, const TextFormat format) const;
 	
 	void translate(const unsigned int i, const Vector& r); // Translate the ith polygon in the list
 	void rotate(const unsigned int i, const double angle);
@@ -43,6 +129,62 @@ public:
 	void rescaleall(const double x, const double y);
 	void centreall();
 
+	// Transactions: between begin() and commit(), the transformations above are only recorded. Each polygon's
+	// are composed, as they come, into a single affine map (see Polygon::Motion), and commit() applies them all
+	// at once, so the vertices, the spatial index and the image only need updating once for the lot. Until
+	// then, everything else (listings, draw(), queries, save() etc) sees the polygons where they were.
+	// Polygons can still be added and removed in the middle of a transaction. begin() returns false if a
+	// transaction is already open, and commit() if there isn't one.
+	const bool begin();
+	const bool commit();
+	const bool intransaction() const { return transaction; }
+
+	const Box extents() const; // Bounding box of the whole scene
+
+	// Spatial queries - these give positions in the list (1,...,count). They are accelerated by a bounding
+	// box tree if indexing is on, and fall back to checking every polygon otherwise.
+	void setindexing(const bool on);
+	const bool indexing() const { return index != nullptr; }
+	const std::vector<unsigned int> query(const Box& region) const; // Polygons whose bounding boxes overlap region
+	const std::vector<unsigned int> raycast(const Vector& origin, const Vector& direction) const; // Nearest first
+	const Containment contains(const double* x, const double* y, const std::size_t m) const; // Batch of m points
+
+	// Every pair of overlapping polygons (i, j) with i < j, in order
+	const std::vector<std::pair<unsigned int, unsigned int> > collisions() const;
+
+	// Size of draw()'s picture in characters. The whole picture is held in memory, so each side is capped at
+	// maxDrawSize.
+	static const unsigned int maxDrawSize{ 4096 };
 	void setdrawWidth(const unsigned int width);
-	void draw() const;
-};
\ No newline at end of file
+	void setdrawHeight(const unsigned int height);
+	void draw(std::ostream& os = std::cout) const;
+
+	// Render the scene, filled, to a width x height image file (see Render.cpp). The scene is scaled to fit.
+	// The image is streamed to the file a row at a time, so it can be far bigger than memory would allow, but
+	// a row is still held in memory, so neither side may be more than maxImageSize pixels.
+	static const unsigned int maxImageSize{ 1u << 20 };
+	enum ImageFormat { pbm, pgm }; // Black and white, or anti-aliased greyscale
+	enum FillRule { evenodd, nonzero };
+	const bool render(const char* const path, const unsigned int width, const unsigned int height,
+		const ImageFormat format, const FillRule rule) const;
+};
+
+// Split the polygon list [0, count) into chunks and apply body(begin, end) to each - in parallel for large
+// scenes. Each polygon is only touched by one thread.
+template<class Body>
+void PolygonManager::forchunks(const Body& body) const
+{
+	if (polygons.size() < parallelCutoff) {
+		body(std::size_t(0), polygons.size());
+		return;
+	}
+	pool->parallelfor(polygons.size(), grain, body);
+}
+
+template<class Body>
+void PolygonManager::forall(const Body& body) const
+{
+	forchunks([&](const std::size_t begin, const std::size_t end) {
+		for (std::size_t i{ begin }; i < end; i++) { body(polygons[i]); }
+	});
+}
\ No newline at end of file
@@ -0,0 +1,192 @@
+// Render.cpp
+// Definition of PolygonManager::render(): the whole scene as a filled image in a PBM or PGM file.
+
+// The polygons are filled with a scanline algorithm. Every edge goes into an edge table, sorted by its top
+// (in image coords, with y going down the image). Going down the image, edges join the active edge table when
+// the scanline reaches their top and leave it when it passes their bottom. On each scanline the active
+// edges' crossings are sorted by polygon and then x, and each polygon's crossings are paired up into spans by
+// the fill rule; the union of the spans over all the polygons is the part of the scanline that's covered.
+//
+// A pixel counts as covered if its centre is - an edge covers the scanlines whose y is in [top, bottom), and
+// a span covers the pixels whose centre x is in [left, right). The PGM is anti-aliased by using a 4x4 grid of
+// samples in each pixel instead, and setting the grey level from how many are covered.
+//
+// Each row of the image is written out as soon as it's done, so only one row is ever held in memory, however
+// big the image is.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include "PolygonManager.h"
+
+namespace {
+
+	struct Edge {
+		double top, bottom; // top < bottom
+		double x, slope; // x at the top, and dx/dy
+		unsigned int poly;
+		int winding; // +1 going down the image, -1 going up
+	};
+
+	struct Crossing {
+		double x;
+		unsigned int poly;
+		int winding;
+		const bool operator< (const Crossing& rhs) const { return poly != rhs.poly ? poly < rhs.poly : x < rhs.x; }
+	};
+
+	typedef std::pair<std::int64_t, std::int64_t> Span; // [first, last) sample columns
+
+}
+
+const bool PolygonManager::render(const char* const path, const unsigned int width, const unsigned int height,
+	const ImageFormat format, const FillRule rule) const
+{
+	const CommandStats::Scope scope(commandstats, CommandStats::render);
+	commandstats.processed(vertextotal);
+	if (width == 0 || height == 0) {
+		std::cerr << "Error: The image must be at least one pixel wide and high." << std::endl;
+		return false;
+	}
+	if (width > maxImageSize || height > maxImageSize) {
+		std::cerr << "Error: The image can be at most " << maxImageSize << " pixels wide and high." << std::endl;
+		return false;
+	}
+	std::FILE* const out{ std::fopen(path, "wb") };
+	if (out == nullptr) {
+		std::cerr << "Error: Could not open " << path << " for writing." << std::endl;
+		return false;
+	}
+	std::setvbuf(out, nullptr, _IOFBF, 1 << 20);
+	if (format == pbm) { std::fprintf(out, "P4\n%u %u\n", width, height); }
+	else { std::fprintf(out, "P5\n%u %u\n255\n", width, height); }
+
+	// Fit the scene to the image, keeping its shape, with a 2.5% border all round
+	const Box scene{ extents() };
+	const double sceneWidth{ 1.05 * scene.width() }, sceneHeight{ 1.05 * scene.height() };
+	const double scale{ std::fmin(width / sceneWidth, height / sceneHeight) };
+	const double midX{ 0.5 * (scene.min.getx() + scene.max.getx()) }, midY{ 0.5 * (scene.min.gety() + scene.max.gety()) };
+
+	// Edge table
+	forall([](const Polygon* poly) { poly->materialise(); });
+	std::vector<Edge> edges;
+	if (std::isfinite(scale)) { // Otherwise the scene is empty
+		std::size_t total{ 0 };
+		for (auto it = polygons.cbegin(); it != polygons.cend(); it++) { total += (*it)->size(); }
+		edges.reserve(total);
+		for (unsigned int p{ 0 }; p < polygons.size(); p++) {
+			const Polygon& poly{ *polygons[p] };
+			const double* const px{ poly.x() };
+			const double* const py{ poly.y() };
+			for (unsigned int i{ 0 }; i < poly.size(); i++) {
+				const unsigned int j{ (i == poly.size() - 1) ? 0 : i + 1 };
+				const double x1{ (px[i] - midX) * scale + 0.5 * width }, y1{ (midY - py[i]) * scale + 0.5 * height };
+				const double x2{ (px[j] - midX) * scale + 0.5 * width }, y2{ (midY - py[j]) * scale + 0.5 * height };
+				if (y1 == y2) { continue; } // Horizontal edges never cross a scanline
+				const double slope{ (x2 - x1) / (y2 - y1) };
+				if (y1 < y2) { edges.push_back(Edge{ y1, y2, x1, slope, p, 1 }); }
+				else { edges.push_back(Edge{ y2, y1, x2, slope, p, -1 }); }
+			}
+		}
+		std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) { return a.top < b.top; });
+	}
+
+	const unsigned int samples{ format == pbm ? 1u : 4u }; // Per pixel, in each direction
+	const std::int64_t columns{ (std::int64_t)width * samples };
+	std::vector<unsigned int> coverage(width); // Samples covered in each pixel of the row
+	std::vector<int> full(std::size_t(width) + 1); // Runs of fully covered pixels, as differences
+	std::vector<unsigned char> row(format == pbm ? (std::size_t(width) + 7) / 8 : std::size_t(width));
+	std::vector<const Edge*> active;
+	std::vector<Crossing> crossings;
+	std::vector<Span> spans;
+	std::size_t next{ 0 }; // First edge not yet active
+
+	// Add the samples in [first, last) to the row
+	const auto cover = [&](const std::int64_t first, const std::int64_t last) {
+		const std::int64_t p{ first / samples }, q{ last / samples };
+		if (p == q) {
+			coverage[p] += (unsigned int)(last - first);
+			return;
+		}
+		coverage[p] += (unsigned int)(samples - first % samples);
+		full[p + 1]++;
+		full[q]--;
+		if (last % samples != 0) { coverage[q] += (unsigned int)(last % samples); }
+	};
+
+	for (unsigned int r{ 0 }; r < height; r++) {
+		std::fill(coverage.begin(), coverage.end(), 0);
+		std::fill(full.begin(), full.end(), 0);
+
+		for (unsigned int s{ 0 }; s < samples; s++) {
+			const double y{ r + (s + 0.5) / samples };
+			while (next < edges.size() && edges[next].top <= y) { active.push_back(&edges[next++]); }
+			active.erase(std::remove_if(active.begin(), active.end(), [y](const Edge* e) { return e->bottom <= y; }),
+				active.end());
+
+			crossings.clear();
+			for (auto it = active.cbegin(); it != active.cend(); it++) {
+				const Edge& e{ **it };
+				crossings.push_back(Crossing{ e.x + (y - e.top) * e.slope, e.poly, e.winding });
+			}
+			std::sort(crossings.begin(), crossings.end());
+
+			// Spans of each polygon, from its crossings
+			spans.clear();
+			const auto addspan = [&](const double left, const double right) {
+				const std::int64_t first{ std::max<std::int64_t>((std::int64_t)std::ceil(left * samples - 0.5), 0) };
+				const std::int64_t last{ std::min<std::int64_t>((std::int64_t)std::ceil(right * samples - 0.5), columns) };
+				if (first < last) { spans.push_back(Span(first, last)); }
+			};
+			for (std::size_t i{ 0 }; i < crossings.size(); ) {
+				std::size_t end{ i };
+				while (end < crossings.size() && crossings[end].poly == crossings[i].poly) { end++; }
+				if (rule == evenodd) {
+					for (std::size_t k{ i }; k + 1 < end; k += 2) { addspan(crossings[k].x, crossings[k + 1].x); }
+				}
+				else {
+					int winding{ 0 };
+					double left{ 0 };
+					for (std::size_t k{ i }; k < end; k++) {
+						if (winding == 0) { left = crossings[k].x; }
+						winding += crossings[k].winding;
+						if (winding == 0) { addspan(left, crossings[k].x); }
+					}
+				}
+				i = end;
+			}
+
+			// Union of the spans - overlapping polygons mustn't count twice
+			std::sort(spans.begin(), spans.end());
+			for (std::size_t i{ 0 }; i < spans.size(); ) {
+				const std::int64_t first{ spans[i].first };
+				std::int64_t last{ spans[i].second };
+				for (i++; i < spans.size() && spans[i].first <= last; i++) { last = std::max(last, spans[i].second); }
+				cover(first, last);
+			}
+		}
+
+		// Write the row
+		int run{ 0 };
+		const unsigned int total{ samples * samples };
+		if (format == pbm) { std::fill(row.begin(), row.end(), 0); }
+		for (unsigned int c{ 0 }; c < width; c++) {
+			run += full[c];
+			const unsigned int covered{ coverage[c] + (unsigned int)run * samples };
+			if (format == pbm) {
+				if (covered != 0) { row[c / 8] |= (unsigned char)(0x80 >> (c % 8)); } // 1 is black
+			}
+			else { row[c] = (unsigned char)(255 - (255 * covered + total / 2) / total); } // 255 is white
+		}
+		std::fwrite(row.data(), 1, row.size(), out);
+	}
+
+	const bool failed{ std::ferror(out) != 0 };
+	if (std::fclose(out) != 0 || failed) {
+		std::cerr << "Error: Could not write " << path << "." << std::endl;
+		return false;
+	}
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+// SlabIndex.cpp
+// Edge-slab structure for point-in-polygon tests on polygons with many vertices.
+
+#include <algorithm>
+#include "SlabIndex.h"
+
+// Each edge is added to every slab between its lower and upper ends. The slab lists are laid out one after
+// another in a single array: count the edges in each slab first, then fill them in.
+SlabIndex::SlabIndex(const double* x, const double* y, const unsigned int n) :
+	ys(y, y + n),
+	usable(false)
+{
+	std::sort(ys.begin(), ys.end());
+	ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+	if (ys.size() < 2) { return; } // Flat - nothing can be inside
+
+	const std::size_t slabs{ ys.size() - 1 };
+	const auto slab = [&](const double v) { return (std::size_t)(std::lower_bound(ys.begin(), ys.end(), v) - ys.begin()); };
+	first.assign(slabs + 1, 0);
+	std::size_t total{ 0 };
+	for (unsigned int i{ 0 }, j{ n - 1 }; i < n; j = i++) {
+		if (y[i] == y[j]) { continue; } // Horizontal edges never count
+		const std::size_t lo{ slab(std::min(y[i], y[j])) }, hi{ slab(std::max(y[i], y[j])) };
+		first[lo]++; // Difference array: +1 over [lo, hi)
+		first[hi]--;
+		total += hi - lo;
+	}
+	if (total > maxedges * n) {
+		first.clear();
+		return;
+	}
+	std::size_t running{ 0 }, start{ 0 };
+	for (std::size_t s{ 0 }; s <= slabs; s++) { // Counts -> starting positions
+		running += first[s];
+		first[s] = start;
+		start += running;
+	}
+
+	edges.resize(total);
+	std::vector<std::size_t> next(first.begin(), first.end() - 1);
+	for (unsigned int i{ 0 }, j{ n - 1 }; i < n; j = i++) {
+		if (y[i] == y[j]) { continue; }
+		const Edge e{ x[i], y[i], x[j] - x[i], y[j] - y[i] };
+		const std::size_t lo{ slab(std::min(y[i], y[j])) }, hi{ slab(std::max(y[i], y[j])) };
+		for (std::size_t s{ lo }; s < hi; s++) { edges[next[s]++] = e; }
+	}
+	usable = true;
+}
+
+const bool SlabIndex::contains(const double px, const double py) const
+{
+	if (!(py >= ys.front() && py < ys.back())) { return false; }
+	const std::size_t s{ (std::size_t)(std::upper_bound(ys.begin(), ys.end(), py) - ys.begin()) - 1 };
+	bool in{ false };
+	for (std::size_t k{ first[s] }; k < first[s + 1]; k++) {
+		const Edge& e{ edges[k] };
+		const double cross{ e.dx * (py - e.y) - e.dy * (px - e.x) };
+		in ^= (e.dy > 0 ? cross > 0 : cross < 0);
+	}
+	return in;
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+// SlabIndex.h
+// Edge-slab structure for point-in-polygon tests on polygons with many vertices. The plane is cut into
+// horizontal slabs at every vertex y, so no vertex lies strictly inside a slab; each slab keeps the edges
+// that span it. A point is tested by finding its slab with a binary search and counting crossings with that
+// slab's edges only, rather than with every edge of the polygon.
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+class SlabIndex {
+private:
+	struct Edge {
+		double x, y; // Start of the edge
+		double dx, dy; // Start to end
+	};
+
+	std::vector<double> ys; // Slab boundaries, in increasing order; slab s is [ys[s], ys[s + 1])
+	std::vector<std::size_t> first; // Edges of slab s are edges[first[s]],...,edges[first[s + 1] - 1]
+	std::vector<Edge> edges;
+	bool usable;
+
+	static const std::size_t maxedges{ 16 }; // Give up if there would be more than this many edges per vertex
+
+public:
+	SlabIndex(const double* x, const double* y, const unsigned int n);
+	~SlabIndex() {}
+
+	// False if the polygon is so convoluted that the slabs would take too much memory. The test should then
+	// be done against every edge instead.
+	const bool valid() const { return usable; }
+
+	const bool contains(const double px, const double py) const; // Same rule as kernel::crossings()
+};
\ No newline at end of file
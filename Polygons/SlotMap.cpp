@@ -0,0 +1,59 @@
+// SlotMap.cpp
+// Generational handles for items kept in a dense array.
+
+#include <iostream>
+#include "SlotMap.h"
+
+const SlotMap::Handle SlotMap::insert()
+{
+	std::uint32_t slot;
+	if (freelist != none) {
+		slot = freelist;
+		freelist = slots[slot].position;
+	}
+	else {
+		if (slots.size() == none) {
+			std::cerr << "Error: Too many polygons." << std::endl;
+			exit(1);
+		}
+		slot = (std::uint32_t)slots.size();
+		slots.push_back(Slot{ 0, 0 });
+	}
+	slots[slot].position = (std::uint32_t)owners.size();
+	owners.push_back(slot);
+	return Handle{ slot, slots[slot].generation };
+}
+
+const std::size_t SlotMap::erase(const Handle h)
+{
+	const std::uint32_t position{ slots[h.slot].position };
+	const std::uint32_t moved{ owners.back() };
+	owners[position] = moved;
+	slots[moved].position = position;
+	owners.pop_back();
+
+	slots[h.slot].generation++;
+	slots[h.slot].position = freelist;
+	freelist = h.slot;
+	return position;
+}
+
+void SlotMap::reserve(const std::size_t n)
+{
+	slots.reserve(n);
+	owners.reserve(n);
+	return;
+}
+
+// Bumping every slot's generation (rather than just dropping the slots) keeps old handles invalid
+void SlotMap::clear()
+{
+	owners.clear();
+	freelist = none;
+	for (std::uint32_t s{ 0 }; s < slots.size(); s++) {
+		slots[s].generation++;
+		slots[s].position = freelist;
+		freelist = s;
+	}
+	return;
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+// SlotMap.h
+// Generational handles for items kept in a dense array. The items themselves live in the caller's array(s);
+// the slot map just keeps track of which position in the array each handle refers to. Removal is
+// swap-and-pop: the last item is moved into the gap, so the array stays dense and removal is O(1). A handle
+// stays valid however the items move around, until its own item is removed - after that it is recognised as
+// stale, even if its slot has since been reused.
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class SlotMap {
+public:
+	struct Handle {
+		std::uint32_t slot;
+		std::uint32_t generation; // Bumped every time the slot is freed
+
+		constexpr const bool operator== (const Handle& rhs) const { return slot == rhs.slot && generation == rhs.generation; }
+		constexpr const bool operator!= (const Handle& rhs) const { return !(*this == rhs); }
+	};
+
+private:
+	struct Slot {
+		std::uint32_t position; // Position of the item in the dense array, or the next free slot
+		std::uint32_t generation;
+	};
+
+	std::vector<Slot> slots;
+	std::vector<std::uint32_t> owners; // Slot of the item at each position
+	std::uint32_t freelist; // First free slot, or none
+
+	static const std::uint32_t none{ 0xffffffff };
+
+public:
+	SlotMap() : freelist(none) {}
+	~SlotMap() {}
+
+	const std::size_t size() const { return owners.size(); }
+
+	const Handle insert(); // For a new item at the end of the array (position size() - 1 afterwards)
+
+	// Forget h, and return its item's position. The caller must then move the last item into that position
+	// and shrink the array by one.
+	const std::size_t erase(const Handle h);
+
+	const bool valid(const Handle h) const
+	{
+		return h.slot < slots.size() && slots[h.slot].generation == h.generation;
+	}
+	const std::size_t position(const Handle h) const { return slots[h.slot].position; } // h must be valid
+	const Handle handle(const std::size_t position) const
+	{
+		const std::uint32_t slot{ owners[position] };
+		return Handle{ slot, slots[slot].generation };
+	}
+
+	void reserve(const std::size_t n);
+	void clear(); // Invalidates every handle given out so far
+};
\ No newline at end of file
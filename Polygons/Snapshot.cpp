@@ -0,0 +1,200 @@
+// Snapshot.cpp
+// Binary snapshot format for a whole scene, and the definitions of PolygonManager::save() and load().
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include "Snapshot.h"
+#include "Derived shapes.h"
+#include "PolygonManager.h"
+
+const snapshot::Type snapshot::types[snapshot::knowntypes]{
+	{ "GeneralPoly" }, { "Isosceles" }, { "Rectangle" }, { "Pentagon" }, { "Hexagon" }
+};
+
+const bool snapshot::littleendian()
+{
+	const std::uint32_t one{ 1 };
+	unsigned char first;
+	std::memcpy(&first, &one, 1);
+	return first == 1;
+}
+
+// Only the header and the section bounds are checked here, so opening a snapshot costs the same however big
+// it is. The polygon table is checked as it is used (see PolygonManager::load()).
+snapshot::View::View(const char* const path) :
+	file(path),
+	header(nullptr),
+	problem(nullptr)
+{
+	if (!file.isopen()) {
+		problem = "could not open the file";
+		return;
+	}
+	if (!littleendian()) {
+		problem = "snapshots can only be used on little-endian machines";
+		return;
+	}
+	if (file.size() < sizeof(Header)) {
+		problem = "the file is too short";
+		return;
+	}
+	header = reinterpret_cast<const Header*>(file.data());
+	if (std::memcmp(header->magic, magic, sizeof(magic)) != 0) {
+		problem = "not a snapshot file";
+		return;
+	}
+	if (header->version != version) {
+		problem = "unsupported snapshot version";
+		return;
+	}
+	const std::uint64_t size{ file.size() };
+	const auto fits = [&](const std::uint64_t offset, const std::uint64_t count, const std::uint64_t itemsize) {
+		return offset % 8 == 0 && offset <= size && count <= (size - offset) / itemsize;
+	};
+	if (!fits(header->typesoffset, header->typecount, sizeof(Type)) || !fits(header->polysoffset, header->polycount, sizeof(Poly))
+		|| !fits(header->xoffset, header->vertexcount, sizeof(double)) || !fits(header->yoffset, header->vertexcount, sizeof(double))) {
+		problem = "the file is truncated or corrupt";
+		return;
+	}
+}
+
+// Save and load:
+
+// Written straight through a large stdio buffer: header, type table, polygon table, then the x and y coords.
+// The coords are taken from the local arrays of the store, so nothing needs materialising.
+const bool PolygonManager::save(const char* const path) const
+{
+	const CommandStats::Scope scope(commandstats, CommandStats::save);
+	commandstats.processed(vertextotal);
+	using namespace snapshot;
+	if (!littleendian()) {
+		std::cerr << "Error: Snapshots can only be saved on little-endian machines." << std::endl;
+		return false;
+	}
+	std::FILE* const out{ std::fopen(path, "wb") };
+	if (out == nullptr) {
+		std::cerr << "Error: Could not open " << path << " for writing." << std::endl;
+		return false;
+	}
+	std::setvbuf(out, nullptr, _IOFBF, 1 << 20);
+
+	Header header;
+	std::memcpy(header.magic, magic, sizeof(magic));
+	header.version = version;
+	header.typecount = knowntypes;
+	header.polycount = polygons.size();
+	header.vertexcount = 0;
+	for (auto it = polygons.cbegin(); it != polygons.cend(); it++) { header.vertexcount += (*it)->size(); }
+	header.typesoffset = sizeof(Header);
+	header.polysoffset = header.typesoffset + knowntypes * sizeof(Type);
+	header.xoffset = header.polysoffset + header.polycount * sizeof(Poly);
+	header.yoffset = header.xoffset + header.vertexcount * sizeof(double);
+	std::fwrite(&header, sizeof(header), 1, out);
+	std::fwrite(types, sizeof(Type), knowntypes, out);
+
+	std::uint64_t first{ 0 };
+	for (auto it = polygons.cbegin(); it != polygons.cend(); it++) {
+		const Polygon* const poly{ *it };
+		Poly record;
+		record.type = dynamic_cast<const Isosceles*>(poly) ? isosceles
+			: dynamic_cast<const Rectangle*>(poly) ? rectangle
+			: dynamic_cast<const Pentagon*>(poly) ? pentagon
+			: dynamic_cast<const Hexagon*>(poly) ? hexagon
+			: ngon;
+		record.count = poly->size();
+		record.first = first;
+		poly->getpose().coefficients(record.pose);
+		const SymmetricPoly* const symmetric{ dynamic_cast<const SymmetricPoly*>(poly) };
+		record.orient = symmetric ? symmetric->orientation() : 0;
+		std::fwrite(&record, sizeof(record), 1, out);
+		first += poly->size();
+	}
+	for (auto it = polygons.cbegin(); it != polygons.cend(); it++) {
+		std::fwrite(store.localx() + (*it)->storeoffset(), sizeof(double), (*it)->size(), out);
+	}
+	for (auto it = polygons.cbegin(); it != polygons.cend(); it++) {
+		std::fwrite(store.localy() + (*it)->storeoffset(), sizeof(double), (*it)->size(), out);
+	}
+
+	const bool failed{ std::ferror(out) != 0 };
+	if (std::fclose(out) != 0 || failed) {
+		std::cerr << "Error: Could not write " << path << "." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// Replaces the current scene. The file's type table is matched to ours by name, and the whole polygon table
+// is checked before anything is changed, so a bad file leaves the scene as it was. The index (if on) is
+// built once at the end rather than updated for each polygon. The vertices are copied out of the mapping,
+// which is unmapped again on return.
+const bool PolygonManager::load(const char* const path)
+{
+	const CommandStats::Scope scope(commandstats, CommandStats::load);
+	using namespace snapshot;
+	const View view(path);
+	if (!view.isvalid()) {
+		std::cerr << "Error: Could not load " << path << ": " << view.error() << "." << std::endl;
+		return false;
+	}
+
+	std::vector<TypeId> typemap(view.typecount(), knowntypes); // File's type ids -> ours (knowntypes if unknown)
+	for (std::size_t t{ 0 }; t < view.typecount(); t++) {
+		const Type& type{ view.types()[t] };
+		if (std::memchr(type.name, '\0', sizeof(type.name)) == nullptr) { continue; }
+		for (std::uint32_t k{ 0 }; k < knowntypes; k++) {
+			if (std::strcmp(type.name, types[k].name) == 0) { typemap[t] = TypeId(k); }
+		}
+	}
+	// Every number must be finite too: a NaN or infinite coord or pose would poison the polygon's cached area,
+	// centre and bounds, and the index
+	const auto finite = [](const double* values, const std::size_t count) {
+		for (std::size_t k{ 0 }; k < count; k++) {
+			if (!std::isfinite(values[k])) { return false; }
+		}
+		return true;
+	};
+	const Poly* const records{ view.polys() };
+	for (std::size_t i{ 0 }; i < view.polycount(); i++) {
+		const Poly& record{ records[i] };
+		if (record.type >= typemap.size() || typemap[record.type] == knowntypes || record.count < 3
+			|| record.first > view.vertexcount() || record.count > view.vertexcount() - record.first
+			|| !finite(record.pose, 6) || !std::isfinite(record.orient)
+			|| !finite(view.x() + record.first, record.count) || !finite(view.y() + record.first, record.count)) {
+			std::cerr << "Error: Could not load " << path << ": polygon " << i + 1 << " is corrupt." << std::endl;
+			return false;
+		}
+	}
+
+	clear();
+	const bool indexed{ index != nullptr };
+	index.reset();
+	reserve(view.polycount(), view.vertexcount());
+	for (std::size_t i{ 0 }; i < view.polycount(); i++) {
+		const Poly& record{ records[i] };
+		const double* const x{ view.x() + record.first };
+		const double* const y{ view.y() + record.first };
+		Polygon* poly;
+		switch (typemap[record.type]) {
+		case isosceles: poly = fact::createIsosceles(1, 1, &store, &arena); break;
+		case rectangle: poly = fact::createRectangle(1, 1, &store, &arena); break;
+		case pentagon: poly = fact::createPentagon(1, &store, &arena); break;
+		case hexagon: poly = fact::createHexagon(1, &store, &arena); break;
+		default: poly = fact::createGenPoly(record.count, x, y, &store, &arena); break;
+		}
+		if (poly->size() != record.count) { // E.g. a 'Pentagon' without five vertices
+			arena.destroy(poly);
+			poly = fact::createGenPoly(record.count, x, y, &store, &arena);
+		}
+		const double* const m{ record.pose };
+		poly->setlocal(x, y, Affine(Matrix(m[0], m[1], m[3], m[4]), Vector(m[2], m[5])));
+		SymmetricPoly* const symmetric{ dynamic_cast<SymmetricPoly*>(poly) };
+		if (symmetric) { symmetric->setorientation(record.orient); }
+		add(poly);
+	}
+	if (indexed) { setindexing(true); }
+	return true;
+}
\ No newline at end of file
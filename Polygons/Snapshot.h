@@ -0,0 +1,82 @@
+// Snapshot.h
+// Binary snapshot format for a whole scene, written by PolygonManager::save() and read by
+// PolygonManager::load(). The file is laid out so it can be memory-mapped and read without parsing:
+//
+//		Header
+//		Shape type table: typecount entries
+//		Polygon table: polycount entries
+//		Local x coords of every vertex, polygon after polygon (vertexcount doubles)
+//		Local y coords, likewise
+//
+// Everything is little-endian, and every section starts on an 8 byte boundary. Each polygon is stored as
+// its local vertices plus its pose (see Polygon.h), so a loaded scene is exactly the saved one.
+// load() reads the tables straight from the mapping, but it still copies the vertices into the scene's
+// VertexStore (and works out their world coords), so the file can be closed once it returns; the store does
+// not adopt the mapped arrays.
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "MappedFile.h"
+
+namespace snapshot {
+
+	const char magic[8]{ 'P', 'O', 'L', 'Y', 'S', 'N', 'A', 'P' };
+	const std::uint32_t version{ 1 };
+
+	struct Header {
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t typecount;
+		std::uint64_t polycount;
+		std::uint64_t vertexcount;
+		std::uint64_t typesoffset; // Byte offsets of the sections from the start of the file
+		std::uint64_t polysoffset;
+		std::uint64_t xoffset;
+		std::uint64_t yoffset;
+	};
+
+	struct Type {
+		char name[32]; // Null-terminated
+	};
+
+	// Shape types, in the order of the type table this version writes
+	enum TypeId : std::uint32_t { ngon, isosceles, rectangle, pentagon, hexagon, knowntypes };
+	extern const Type types[knowntypes];
+
+	struct Poly {
+		std::uint32_t type;
+		std::uint32_t count; // Number of vertices
+		std::uint64_t first; // Index of the first vertex in the coord arrays
+		double pose[6]; // As given by Affine::coefficients()
+		double orient; // Orientation of SymmetricPolys (0 for the others)
+	};
+
+	static_assert(sizeof(Header) == 64 && sizeof(Type) == 32 && sizeof(Poly) == 72, "Snapshot structs must not be padded");
+
+	const bool littleendian(); // Is this machine little-endian? (The format can only be used in place if so.)
+
+	// A snapshot file, mapped into memory and checked, but otherwise used as it is
+	class View {
+	private:
+		MappedFile file;
+		const Header* header;
+		const char* problem; // Why the file can't be used, or nullptr
+
+	public:
+		explicit View(const char* const path);
+		~View() {}
+
+		const bool isvalid() const { return problem == nullptr; }
+		const char* error() const { return problem; }
+
+		const std::size_t typecount() const { return header->typecount; }
+		const std::size_t polycount() const { return (std::size_t)header->polycount; }
+		const std::size_t vertexcount() const { return (std::size_t)header->vertexcount; }
+		const Type* types() const { return reinterpret_cast<const Type*>(file.data() + header->typesoffset); }
+		const Poly* polys() const { return reinterpret_cast<const Poly*>(file.data() + header->polysoffset); }
+		const double* x() const { return reinterpret_cast<const double*>(file.data() + header->xoffset); }
+		const double* y() const { return reinterpret_cast<const double*>(file.data() + header->yoffset); }
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,296 @@
+// TextIO.cpp
+// Definitions of PolygonManager::importtext() and exporttext(): polygons as WKT or CSV text.
+
+// Formats:
+//	WKT - one polygon per line, e.g. 'POLYGON ((0 0, 4 0, 4 3, 0 0))'. The ring is closed by repeating the first
+//		vertex; the repeat is dropped on import. Only simple polygons are supported (no holes).
+//	CSV - one vertex per line, as 'id,x,y'. Consecutive lines with the same id make up one polygon. An optional
+//		header line is skipped.
+// Coords must be finite: from_chars also reads 'nan', 'inf' and 'infinity', but those are rejected.
+//
+// Importing maps the file into memory and splits it into chunks at line boundaries, which are parsed in
+// parallel on the thread pool with std::from_chars. The results are then turned into GeneralPolys in file
+// order. Exporting formats chunks of polygons in parallel with std::to_chars, then writes the chunks out in
+// order.
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "Derived shapes.h"
+#include "MappedFile.h"
+#include "PolygonManager.h"
+
+namespace {
+
+	const std::size_t chunkSize{ 1 << 22 }; // Bytes of text per chunk when importing
+	const std::size_t exportGrain{ 4096 }; // Polygons per chunk when exporting
+
+	// The polygons parsed from one chunk of text
+	struct Parsed {
+		std::vector<double> x, y;
+		std::vector<unsigned int> counts; // Vertices in each polygon
+		std::vector<std::string> ids; // CSV only: id of each polygon
+		std::size_t lines; // Lines in the chunk
+		std::size_t errorline; // Line (within the chunk) of the first error, or 0
+		const char* error;
+
+		Parsed() : lines(0), errorline(0), error(nullptr) {}
+		void fail(const char* const message) {
+			if (errorline == 0) {
+				errorline = lines;
+				error = message;
+			}
+		}
+	};
+
+	inline const char* skipspaces(const char* p, const char* const end)
+	{
+		while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) { p++; }
+		return p;
+	}
+
+	inline bool readnumber(const char*& p, const char* const end, double& value)
+	{
+		const std::from_chars_result result{ std::from_chars(p, end, value) };
+		if (result.ec != std::errc()) { return false; }
+		p = result.ptr;
+		return true;
+	}
+
+	// One line of WKT, e.g. 'POLYGON ((0 0, 4 0, 4 3, 0 0))'
+	void parsewkt(const char* p, const char* const end, Parsed& out)
+	{
+		p = skipspaces(p, end);
+		if (p == end) { return; } // Blank line
+		const char keyword[]{ "POLYGON" };
+		for (const char* k{ keyword }; *k != '\0'; k++, p++) {
+			if (p == end || (*p & ~0x20) != *k) { return out.fail("expected POLYGON"); } // Either case
+		}
+		p = skipspaces(p, end);
+		if (p == end || *p++ != '(') { return out.fail("expected '('"); }
+		p = skipspaces(p, end);
+		if (p == end || *p++ != '(') { return out.fail("expected '('"); }
+
+		const std::size_t first{ out.x.size() };
+		while (true) {
+			double x, y;
+			p = skipspaces(p, end);
+			if (!readnumber(p, end, x)) { return out.fail("expected a number"); }
+			p = skipspaces(p, end);
+			if (!readnumber(p, end, y)) { return out.fail("expected a number"); }
+			if (!std::isfinite(x) || !std::isfinite(y)) { return out.fail("invalid number"); }
+			out.x.push_back(x);
+			out.y.push_back(y);
+			p = skipspaces(p, end);
+			if (p == end) { return out.fail("unexpected end of line"); }
+			if (*p == ')') { break; }
+			if (*p++ != ',') { return out.fail("expected ',' or ')'"); }
+		}
+		p = skipspaces(p + 1, end);
+		if (p != end && *p == ',') { return out.fail("polygons with holes are not supported"); }
+		if (p == end || *p++ != ')') { return out.fail("expected ')'"); }
+		if (skipspaces(p, end) != end) { return out.fail("unexpected text after the polygon"); }
+
+		std::size_t count{ out.x.size() - first };
+		if (count > 1 && out.x.back() == out.x[first] && out.y.back() == out.y[first]) { // Closing vertex
+			out.x.pop_back();
+			out.y.pop_back();
+			count--;
+		}
+		if (count < 3) { return out.fail("a polygon needs at least three vertices"); }
+		out.counts.push_back((unsigned int)count);
+	}
+
+	// One line of CSV, 'id,x,y'. A line that doesn't start a new id adds a vertex to the last polygon.
+	void parsecsv(const char* p, const char* const end, Parsed& out, const bool firstline)
+	{
+		p = skipspaces(p, end);
+		if (p == end) { return; }
+		const char* const id{ p };
+		while (p < end && *p != ',') { p++; }
+		const char* idend{ p };
+		while (idend > id && (idend[-1] == ' ' || idend[-1] == '\t')) { idend--; }
+		if (p == end) { return out.fail("expected 'id,x,y'"); }
+
+		double x, y;
+		p = skipspaces(p + 1, end);
+		if (!readnumber(p, end, x)) {
+			if (firstline) { return; } // Header
+			return out.fail("expected a number");
+		}
+		p = skipspaces(p, end);
+		if (p == end || *p++ != ',') { return out.fail("expected 'id,x,y'"); }
+		p = skipspaces(p, end);
+		if (!readnumber(p, end, y)) { return out.fail("expected a number"); }
+		if (!std::isfinite(x) || !std::isfinite(y)) { return out.fail("invalid number"); }
+		if (skipspaces(p, end) != end) { return out.fail("unexpected text after 'id,x,y'"); }
+
+		const std::size_t length{ (std::size_t)(idend - id) };
+		if (out.ids.empty() || out.ids.back().size() != length || std::memcmp(out.ids.back().data(), id, length) != 0) {
+			out.ids.emplace_back(id, length);
+			out.counts.push_back(0);
+		}
+		out.x.push_back(x);
+		out.y.push_back(y);
+		out.counts.back()++;
+	}
+
+	inline void append(std::string& buffer, const double value)
+	{
+		char text[32];
+		const std::to_chars_result result{ std::to_chars(text, text + sizeof(text), value) }; // Shortest round-trip form
+		buffer.append(text, result.ptr);
+	}
+
+}
+
+// Import: parse every chunk, check for errors (reporting the earliest), and only then add the polygons, so a bad
+// file adds nothing. The index, if on, is rebuilt once at the end.
+const bool PolygonManager::importtext(const char* const path, const TextFormat format)
+{
+	const CommandStats::Scope scope(commandstats, CommandStats::importtext);
+	const MappedFile file(path);
+	if (!file.isopen()) {
+		std::cerr << "Error: Could not open " << path << "." << std::endl;
+		return false;
+	}
+
+	// Chunk boundaries: roughly every chunkSize bytes, moved on to the start of the next line
+	const char* const text{ file.data() };
+	const char* const end{ text + file.size() };
+	std::vector<const char*> bounds(1, text);
+	while (bounds.back() != end) {
+		const char* next{ (std::size_t)(end - bounds.back()) > chunkSize ? bounds.back() + chunkSize : end };
+		const void* const newline{ std::memchr(next, '\n', end - next) };
+		bounds.push_back(newline ? static_cast<const char*>(newline) + 1 : end);
+	}
+	const std::size_t chunks{ bounds.size() - 1 };
+
+	std::vector<Parsed> parsed(chunks);
+	pool->run(chunks, [&](const std::size_t c) {
+		Parsed& out{ parsed[c] };
+		const char* p{ bounds[c] };
+		while (p < bounds[c + 1]) {
+			const void* const newline{ std::memchr(p, '\n', bounds[c + 1] - p) };
+			const char* const lineend{ newline ? static_cast<const char*>(newline) : bounds[c + 1] };
+			out.lines++;
+			if (format == wkt) { parsewkt(p, lineend, out); }
+			else { parsecsv(p, lineend, out, c == 0 && out.lines == 1); }
+			p = lineend + 1;
+		}
+	});
+
+	std::size_t lines{ 0 }, total{ 0 };
+	for (std::size_t c{ 0 }; c < chunks; c++) {
+		if (parsed[c].errorline != 0) {
+			std::cerr << "Error: " << path << ", line " << lines + parsed[c].errorline << ": " << parsed[c].error << "." << std::endl;
+			return false;
+		}
+		lines += parsed[c].lines;
+		total += parsed[c].x.size();
+	}
+
+	// Join the chunks up. A CSV polygon may run over the end of one chunk into the next.
+	std::vector<double> x, y;
+	std::vector<unsigned int> counts;
+	x.reserve(total);
+	y.reserve(total);
+	for (std::size_t c{ 0 }; c < chunks; c++) {
+		const Parsed& chunk{ parsed[c] };
+		x.insert(x.end(), chunk.x.begin(), chunk.x.end());
+		y.insert(y.end(), chunk.y.begin(), chunk.y.end());
+		std::size_t k{ 0 };
+		if (format == csv && !chunk.ids.empty() && c > 0 && !parsed[c - 1].ids.empty()
+			&& parsed[c - 1].ids.back() == chunk.ids.front()) {
+			counts.back() += chunk.counts.front();
+			k = 1;
+		}
+		counts.insert(counts.end(), chunk.counts.begin() + k, chunk.counts.end());
+	}
+	if (format == csv) {
+		for (std::size_t i{ 0 }; i < counts.size(); i++) {
+			if (counts[i] < 3) {
+				std::cerr << "Error: " << path << ": polygon " << i + 1 << " has fewer than three vertices." << std::endl;
+				return false;
+			}
+		}
+	}
+
+	const bool indexed{ index != nullptr };
+	index.reset();
+	reserve(polygons.size() + counts.size(), store.size() + total);
+	std::size_t first{ 0 };
+	for (auto it = counts.cbegin(); it != counts.cend(); it++) {
+		add(fact::createGenPoly(*it, x.data() + first, y.data() + first, &store, &arena));
+		first += *it;
+	}
+	if (indexed) { setindexing(true); }
+	return true;
+}
+
+// Export: the world coords of each chunk of polygons are formatted into a buffer in parallel, then the buffers
+// are written out in order. This is done a batch of chunks at a time, to bound the memory used.
+const bool PolygonManager::exporttext(const char* const path, const TextFormat format) const
+{
+	const CommandStats::Scope scope(commandstats, CommandStats::exporttext);
+	commandstats.processed(vertextotal);
+	std::FILE* const out{ std::fopen(path, "wb") };
+	if (out == nullptr) {
+		std::cerr << "Error: Could not open " << path << " for writing." << std::endl;
+		return false;
+	}
+	if (format == csv) { std::fputs("id,x,y\n", out); }
+
+	const std::size_t batch{ 4 * exportGrain * pool->size() };
+	std::vector<std::string> buffers;
+	for (std::size_t start{ 0 }; start < polygons.size(); start += batch) {
+		const std::size_t stop{ std::min(start + batch, polygons.size()) };
+		buffers.resize((stop - start + exportGrain - 1) / exportGrain);
+		pool->parallelfor(stop - start, exportGrain, [&](const std::size_t begin, const std::size_t end) {
+			std::string& buffer{ buffers[begin / exportGrain] };
+			buffer.clear();
+			for (std::size_t i{ start + begin }; i < start + end; i++) {
+				const Polygon* const poly{ polygons[i] };
+				const double* const x{ poly->x() };
+				const double* const y{ poly->y() };
+				const unsigned int n{ poly->size() };
+				if (format == wkt) {
+					buffer += "POLYGON ((";
+					for (unsigned int k{ 0 }; k <= n; k++) { // Back round to the first vertex to close the ring
+						if (k > 0) { buffer += ", "; }
+						append(buffer, x[k % n]);
+						buffer += ' ';
+						append(buffer, y[k % n]);
+					}
+					buffer += "))\n";
+				}
+				else {
+					char id[16];
+					const std::to_chars_result result{ std::to_chars(id, id + sizeof(id), i + 1) };
+					for (unsigned int k{ 0 }; k < n; k++) {
+						buffer.append(id, result.ptr);
+						buffer += ',';
+						append(buffer, x[k]);
+						buffer += ',';
+						append(buffer, y[k]);
+						buffer += '\n';
+					}
+				}
+			}
+		});
+		for (auto it = buffers.cbegin(); it != buffers.cend(); it++) {
+			std::fwrite(it->data(), 1, it->size(), out);
+		}
+	}
+
+	const bool failed{ std::ferror(out) != 0 };
+	if (std::fclose(out) != 0 || failed) {
+		std::cerr << "Error: Could not write " << path << "." << std::endl;
+		return false;
+	}
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+// ThreadPool.cpp
+// A fixed-size pool of worker threads for running loops in parallel.
+
+#include <iostream>
+#include "ThreadPool.h"
+#include "Trace.h"
+
+namespace {
+	inline std::uint64_t pack(const std::uint64_t begin, const std::uint64_t end) { return (begin << 32) | end; }
+}
+
+ThreadPool::ThreadPool(const unsigned int threads) :
+	task(nullptr),
+	generation(0),
+	active(0),
+	stopping(false)
+{
+	unsigned int total{ threads };
+	if (total == 0) { total = std::thread::hardware_concurrency(); }
+	if (total == 0) { total = 1; } // hardware_concurrency() is allowed to return 0 if it doesn't know
+
+	shares.reset(new std::atomic<std::uint64_t>[total]);
+	for (unsigned int i{ 0 }; i < total; i++) { shares[i] = 0; }
+	for (unsigned int i{ 1 }; i < total; i++) {
+		workers.emplace_back(&ThreadPool::workerloop, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (auto it = workers.begin(); it != workers.end(); it++) {
+		it->join();
+	}
+}
+
+// Split the chunks evenly between the threads, wake the workers and join in. Returns once every chunk is done:
+// each thread only stops working when there is nothing left to take or steal, and the chunks it has already
+// taken are finished by then.
+void ThreadPool::run(const std::size_t chunks, const std::function<void(const std::size_t)>& job)
+{
+	if (chunks == 0) { return; }
+	if (chunks >= (std::size_t(1) << 32)) {
+		std::cerr << "Error: Too many chunks for the thread pool." << std::endl;
+		exit(1);
+	}
+	if (workers.empty() || chunks == 1) { // Nothing to share out
+		for (std::size_t c{ 0 }; c < chunks; c++) { job(c); }
+		return;
+	}
+
+	std::lock_guard<std::mutex> runlock(runmutex);
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		const std::uint64_t n{ size() };
+		for (std::uint64_t i{ 0 }; i < n; i++) {
+			shares[i] = pack(chunks * i / n, chunks * (i + 1) / n);
+		}
+		task = &job;
+		active = (unsigned int)workers.size();
+		generation++;
+	}
+	wake.notify_all();
+
+	work(0);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	finished.wait(lock, [this] { return active == 0; });
+	task = nullptr;
+}
+
+void ThreadPool::workerloop(const unsigned int id)
+{
+	std::uint64_t seen{ 0 };
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [&] { return stopping || generation != seen; });
+			if (stopping) { return; }
+			seen = generation;
+		}
+		work(id);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			active--;
+		}
+		finished.notify_one();
+	}
+}
+
+void ThreadPool::work(const unsigned int id)
+{
+	TRACE_SCOPE("pool", "work");
+	std::size_t chunk;
+	while (take(id, chunk) || steal(id, chunk)) {
+		(*task)(chunk);
+	}
+}
+
+bool ThreadPool::take(const unsigned int id, std::size_t& chunk)
+{
+	std::uint64_t old{ shares[id].load() };
+	while (true) {
+		const std::uint64_t begin{ old >> 32 }, end{ old & 0xffffffff };
+		if (begin >= end) { return false; }
+		if (shares[id].compare_exchange_weak(old, pack(begin + 1, end))) {
+			chunk = (std::size_t)begin;
+			return true;
+		}
+	}
+}
+
+bool ThreadPool::steal(const unsigned int id, std::size_t& chunk)
+{
+	for (unsigned int k{ 1 }; k < size(); k++) {
+		const unsigned int victim{ (id + k) % size() };
+		std::uint64_t old{ shares[victim].load() };
+		while (true) {
+			const std::uint64_t begin{ old >> 32 }, end{ old & 0xffffffff };
+			if (begin >= end) { break; }
+			if (shares[victim].compare_exchange_weak(old, pack(begin, end - 1))) {
+				chunk = (std::size_t)(end - 1);
+				return true;
+			}
+		}
+	}
+	return false;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+// ThreadPool.h
+// A fixed-size pool of worker threads for running loops in parallel. Work is split into chunks; each thread
+// starts with an equal share of the chunks and, once it runs out, steals chunks from the back of the other
+// threads' shares. The calling thread takes part too, so a pool of size 1 has no workers and runs everything
+// on the caller.
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+private:
+	std::vector<std::thread> workers;
+	std::unique_ptr<std::atomic<std::uint64_t>[]> shares; // Per thread: range of chunks left, packed as (begin << 32 | end)
+
+	std::mutex runmutex; // Only one job at a time
+	std::mutex mutex;
+	std::condition_variable wake, finished;
+	const std::function<void(const std::size_t)>* task; // Runs one chunk of the current job
+	std::uint64_t generation; // Incremented for each new job
+	unsigned int active; // Workers still busy with the current job
+	bool stopping;
+
+	void workerloop(const unsigned int id);
+	void work(const unsigned int id); // Run chunks until there are none left anywhere
+	bool take(const unsigned int id, std::size_t& chunk); // From the front of thread id's own share
+	bool steal(const unsigned int id, std::size_t& chunk); // From the back of another thread's share
+
+public:
+	explicit ThreadPool(const unsigned int threads = 0); // 0 = one per hardware thread
+	~ThreadPool();
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator= (const ThreadPool&) = delete;
+
+	const unsigned int size() const { return (unsigned int)workers.size() + 1; } // Including the calling thread
+
+	// Run task(c) for every chunk c = 0,...,chunks-1 and wait for them all to finish
+	void run(const std::size_t chunks, const std::function<void(const std::size_t)>& task);
+
+	// Run body(begin, end) over [0, n), in chunks of grain elements
+	template<class Body>
+	void parallelfor(const std::size_t n, const std::size_t grain, const Body& body);
+
+	// Parallel reduction over [0, n): map(begin, end) gives the result for one chunk, and the chunk results are
+	// then combined in order. The chunks only depend on n and grain, so the result is the same (bit for bit)
+	// whatever the number of threads.
+	template<class T, class Map, class Combine>
+	const T reduce(const std::size_t n, const std::size_t grain, const T& identity, const Map& map,
+		const Combine& combine);
+};
+
+template<class Body>
+void ThreadPool::parallelfor(const std::size_t n, const std::size_t grain, const Body& body)
+{
+	const std::size_t chunks{ (n + grain - 1) / grain };
+	run(chunks, [&](const std::size_t c) {
+		const std::size_t begin{ c * grain };
+		body(begin, (begin + grain < n) ? begin + grain : n);
+	});
+}
+
+template<class T, class Map, class Combine>
+const T ThreadPool::reduce(const std::size_t n, const std::size_t grain, const T& identity, const Map& map,
+	const Combine& combine)
+{
+	const std::size_t chunks{ (n + grain - 1) / grain };
+	std::vector<T> partials(chunks, identity);
+	run(chunks, [&](const std::size_t c) {
+		const std::size_t begin{ c * grain };
+		partials[c] = map(begin, (begin + grain < n) ? begin + grain : n);
+	});
+	T result{ identity };
+	for (std::size_t c{ 0 }; c < chunks; c++) {
+		result = combine(result, partials[c]);
+	}
+	return result;
+}
\ No newline at end of file
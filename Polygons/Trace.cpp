@@ -0,0 +1,185 @@
+// Trace.cpp
+// Opt-in tracing of commands, written as Chrome trace-event JSON.
+
+// Each ring has a single writer (its thread) and a single reader (the flushing thread, or stop() once that has
+// finished). The writer only moves head and the reader only moves tail, so the two just need to publish their
+// positions with release stores and read each other's with acquire loads. Rings are never freed, since a
+// thread keeps a pointer to its own for as long as it lives; a thread that records again in a later session
+// carries on with the same ring.
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Trace.h"
+
+namespace trace {
+
+	std::atomic<bool> on{ false };
+
+	namespace {
+
+		const std::size_t nameLength{ 31 }; // Longest name kept
+
+		struct Event {
+			std::int64_t begin, end;
+			const char* category;
+			char name[nameLength + 1];
+		};
+
+		struct Ring {
+			static const std::size_t capacity{ 8192 };
+			Event events[capacity];
+			std::atomic<std::uint64_t> head{ 0 }, tail{ 0 }; // Events written, and read
+			std::atomic<std::uint64_t> dropped{ 0 };
+			unsigned int tid;
+		};
+
+		std::mutex mutex; // Guards the list of rings, the file and the flushing thread's state
+		std::condition_variable wake;
+		std::vector<std::unique_ptr<Ring>> rings;
+		std::thread flusher;
+		std::FILE* out{ nullptr };
+		bool first; // No event written yet
+		bool stopping;
+		std::int64_t origin; // Times are written relative to the start of tracing
+		thread_local Ring* mine{ nullptr };
+
+		Ring* ring()
+		{
+			if (mine == nullptr) {
+				std::lock_guard<std::mutex> lock(mutex);
+				rings.emplace_back(new Ring);
+				mine = rings.back().get();
+				mine->tid = (unsigned int)rings.size() - 1;
+			}
+			return mine;
+		}
+
+		// Names can come from the user, so anything that would need escaping in JSON is replaced
+		void writeevent(const Event& e, const unsigned int tid)
+		{
+			char name[nameLength + 1];
+			std::size_t i{ 0 };
+			for (; e.name[i] != '\0'; i++) {
+				const unsigned char c{ (unsigned char)e.name[i] };
+				name[i] = (c < 0x20 || c >= 0x7f || c == '"' || c == '\\') ? '?' : (char)c;
+			}
+			name[i] = '\0';
+			const std::int64_t ts{ e.begin - origin }, dur{ e.end - e.begin };
+			std::fprintf(out, "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%lld.%03lld,\"dur\":%lld.%03lld,"
+				"\"pid\":1,\"tid\":%u}", first ? "" : ",", name, e.category, (long long)(ts / 1000),
+				(long long)(ts % 1000), (long long)(dur / 1000), (long long)(dur % 1000), tid);
+			first = false;
+		}
+
+		// Needs the lock
+		void drain()
+		{
+			for (auto it = rings.begin(); it != rings.end(); it++) {
+				Ring& r{ **it };
+				const std::uint64_t head{ r.head.load(std::memory_order_acquire) };
+				std::uint64_t tail{ r.tail.load(std::memory_order_relaxed) };
+				for (; tail != head; tail++) {
+					writeevent(r.events[tail % Ring::capacity], r.tid);
+				}
+				r.tail.store(tail, std::memory_order_release);
+			}
+		}
+
+		void flushloop()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			while (!stopping) {
+				wake.wait_for(lock, std::chrono::milliseconds(10));
+				drain();
+			}
+		}
+
+		void atexitstop() { stop(); }
+
+	}
+
+	const std::int64_t now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	const bool start(const char* const path)
+	{
+		static bool registered{ false };
+		stop();
+		std::lock_guard<std::mutex> lock(mutex);
+		out = std::fopen(path, "w");
+		if (out == nullptr) {
+			std::cerr << "Error: Could not open " << path << " for writing." << std::endl;
+			return false;
+		}
+		std::fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+		first = true;
+		stopping = false;
+		origin = now();
+		for (auto it = rings.begin(); it != rings.end(); it++) {
+			(*it)->tail = (*it)->head.load();
+			(*it)->dropped = 0;
+		}
+		flusher = std::thread(flushloop);
+		if (!registered) {
+			std::atexit(atexitstop);
+			registered = true;
+		}
+		on = true;
+		return true;
+	}
+
+	void stop()
+	{
+		if (!on.exchange(false)) { return; }
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		wake.notify_one();
+		flusher.join();
+
+		// Spans that were already finishing when tracing was turned off may still be being recorded; they
+		// are written here if they have landed, and otherwise skipped by the next start()
+		std::lock_guard<std::mutex> lock(mutex);
+		drain();
+		std::fprintf(out, "\n]}\n");
+		std::fclose(out);
+		out = nullptr;
+		std::uint64_t dropped{ 0 };
+		for (auto it = rings.begin(); it != rings.end(); it++) { dropped += (*it)->dropped; }
+		if (dropped != 0) {
+			std::cerr << "Warning: " << dropped << " trace events were dropped." << std::endl;
+		}
+	}
+
+	void record(const char* category, const char* name, const std::size_t length, const std::int64_t begin,
+		const std::int64_t end)
+	{
+		if (!enabled()) { return; } // Stopped during the span
+		Ring& r{ *ring() };
+		const std::uint64_t head{ r.head.load(std::memory_order_relaxed) };
+		if (head - r.tail.load(std::memory_order_acquire) == Ring::capacity) {
+			r.dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		Event& e{ r.events[head % Ring::capacity] };
+		e.begin = begin;
+		e.end = end;
+		e.category = category;
+		const std::size_t n{ (length < nameLength) ? length : nameLength };
+		std::memcpy(e.name, name, n);
+		e.name[n] = '\0';
+		r.head.store(head + 1, std::memory_order_release);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+// Trace.h
+// Opt-in tracing of commands and their internal phases, written as Chrome trace-event JSON (which can be opened
+// in chrome://tracing or Perfetto). Each span is a "complete" event with a category, a name, a start time and a
+// duration.
+//
+// While tracing is off, a span costs one relaxed atomic load. While it is on, a finished span is copied into a
+// ring buffer belonging to the thread that ran it, without taking any lock; a background thread empties the
+// rings into the file every few milliseconds. If a ring fills up before it is emptied, new spans are dropped
+// (and counted) rather than making the traced thread wait.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace trace {
+
+	extern std::atomic<bool> on;
+	inline const bool enabled() { return on.load(std::memory_order_relaxed); }
+
+	// Start writing spans to the file at path. Tracing stops by itself when the program exits.
+	// Reports any problem to std::cerr.
+	const bool start(const char* const path);
+	void stop(); // Write out any spans left in the rings and close the file
+
+	const std::int64_t now(); // In ns
+	void record(const char* category, const char* name, const std::size_t length, const std::int64_t begin,
+		const std::int64_t end);
+
+	// A span from construction to destruction. The name doesn't need to be null-terminated, but it does need to
+	// outlive the span; only the first few characters are kept.
+	class Span {
+	private:
+		const char* category;
+		const char* name;
+		std::size_t length;
+		std::int64_t begin; // -1 if tracing was off at the start
+	public:
+		Span(const char* category, const char* name, const std::size_t length) :
+			category(category), name(name), length(length), begin(enabled() ? now() : -1) {}
+		Span(const char* category, const char* name) : Span(category, name, std::strlen(name)) {}
+		~Span() { if (begin >= 0) { record(category, name, length, begin, now()); } }
+		Span(const Span&) = delete;
+		Span& operator= (const Span&) = delete;
+	};
+
+}
+
+// Trace the rest of the enclosing block
+#define TRACE_JOIN2(a, b) a##b
+#define TRACE_JOIN(a, b) TRACE_JOIN2(a, b)
+#define TRACE_SCOPE(category, name) const trace::Span TRACE_JOIN(tracespan, __LINE__)(category, name)
\ No newline at end of file
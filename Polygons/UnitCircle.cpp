@@ -0,0 +1,142 @@
+// UnitCircle.cpp
+// Cached unit-circle vertex tables for regular polygons.
+
+// Every vertex comes from the same constexpr function, whichever table it ends up in, so a given n always
+// gives exactly the same vertices. The angle is reduced exactly, in integers, to the nearest multiple of pi/2
+// plus a remainder t with |t| <= pi/4, and the sine and cosine of t are summed from their Taylor series (which
+// have converged to double precision by the 10th term there). This keeps the symmetries exact: e.g. the
+// vertices of a square are exactly (0, 1), (-1, 0), (0, -1) and (1, 0).
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "UnitCircle.h"
+
+namespace circle {
+
+	namespace {
+
+		struct Point { double x, y; };
+
+		constexpr double sinseries(const double t)
+		{
+			double term{ t }, sum{ t };
+			for (int k{ 1 }; k < 10; k++) {
+				term *= -t * t / ((2 * k) * (2 * k + 1));
+				sum += term;
+			}
+			return sum;
+		}
+
+		constexpr double cosseries(const double t)
+		{
+			double term{ 1 }, sum{ 1 };
+			for (int k{ 1 }; k < 10; k++) {
+				term *= -t * t / ((2 * k - 1) * (2 * k));
+				sum += term;
+			}
+			return sum;
+		}
+
+		// The angle is 2*pi*a/(4n) with a = n + 4i (mod 4n), which is q quarter turns plus t = pi*r/(2n)
+		constexpr const Point vertex(const unsigned int i, const unsigned int n)
+		{
+			const std::int64_t a{ (std::int64_t(n) + 4 * std::int64_t(i)) % (4 * std::int64_t(n)) };
+			const std::int64_t q{ (2 * a + n) / (2 * std::int64_t(n)) }; // Nearest quarter turn
+			const double t{ pi * double(a - q * std::int64_t(n)) / (2.0 * n) };
+			const double c{ cosseries(t) }, s{ sinseries(t) };
+			Point p{ c, s };
+			switch (q % 4) {
+			case 1: p = Point{ -s, c }; break;
+			case 2: p = Point{ -c, -s }; break;
+			case 3: p = Point{ s, -c }; break;
+			}
+			return Point{ p.x + 0.0, p.y + 0.0 }; // Turns any -0 into 0
+		}
+
+		// Compile-time tables for n = 3,...,smallMax, one after another
+		constexpr unsigned int smallMax{ 16 };
+		constexpr unsigned int smallTotal{ (smallMax * (smallMax + 1)) / 2 - 3 }; // 3 + 4 + ... + smallMax
+
+		struct SmallTables {
+			double x[smallTotal], y[smallTotal];
+			unsigned int offset[smallMax + 1]; // Of the table for each n
+		};
+
+		constexpr const SmallTables buildsmall()
+		{
+			SmallTables tables{};
+			unsigned int offset{ 0 };
+			for (unsigned int n{ 3 }; n <= smallMax; n++) {
+				tables.offset[n] = offset;
+				for (unsigned int i{ 0 }; i < n; i++) {
+					const Point p{ vertex(i, n) };
+					tables.x[offset + i] = p.x;
+					tables.y[offset + i] = p.y;
+				}
+				offset += n;
+			}
+			return tables;
+		}
+
+		constexpr SmallTables small{ buildsmall() };
+		static_assert(small.x[small.offset[4]] == 0 && small.y[small.offset[4]] == 1, "Vertex 0 must be at the top");
+
+		// Tables for larger n, up to cacheMax, are built when first needed, stored as the n x coords followed
+		// by the n y coords. The map's nodes never move, so a table can be used without the lock once found;
+		// each thread also remembers the last one it used, since polygons tend to come in runs of the same n.
+		constexpr unsigned int cacheMax{ 4096 };
+		std::mutex mutex;
+		std::unordered_map<unsigned int, std::vector<double>> cache;
+		thread_local unsigned int lastn{ 0 };
+		thread_local const double* last{ nullptr };
+
+		const double* table(const unsigned int n)
+		{
+			if (n == lastn) { return last; }
+			std::lock_guard<std::mutex> lock(mutex);
+			std::vector<double>& points{ cache[n] };
+			if (points.empty()) {
+				points.resize(2 * std::size_t(n));
+				for (unsigned int i{ 0 }; i < n; i++) {
+					const Point p{ vertex(i, n) };
+					points[i] = p.x;
+					points[n + i] = p.y;
+				}
+			}
+			lastn = n;
+			last = points.data();
+			return last;
+		}
+
+	}
+
+	void vertices(const unsigned int n, const double R, double* x, double* y)
+	{
+		const double* ux;
+		const double* uy;
+		if (n >= 3 && n <= smallMax) {
+			ux = small.x + small.offset[n];
+			uy = small.y + small.offset[n];
+		}
+		else if (n <= cacheMax) {
+			ux = table(n);
+			uy = ux + n;
+		}
+		else {
+			for (unsigned int i{ 0 }; i < n; i++) {
+				const Point p{ vertex(i, n) };
+				x[i] = R * p.x;
+				y[i] = R * p.y;
+			}
+			return;
+		}
+		for (unsigned int i{ 0 }; i < n; i++) {
+			x[i] = R * ux[i];
+			y[i] = R * uy[i];
+		}
+		return;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+// UnitCircle.h
+// The vertices of regular polygons on the unit circle, for building regular n-gons (GeneralPoly, Pentagon,
+// Hexagon) without working out a sine and cosine for every vertex of every polygon.
+// Vertex i of the n-gon is at angle pi/2 + 2*pi*i/n, i.e. vertex 0 is at the top and they go round
+// counter-clockwise. The tables for small n are built at compile time; the others are built the first time
+// they are asked for and then kept, apart from those for very large n, which are worked out each time.
+#pragma once
+
+namespace circle {
+
+	constexpr double pi{ 3.141592653589793238462643383279502884 };
+
+	// Write the n vertices of the regular n-gon with circumradius R to x, y. Safe to call from any thread.
+	void vertices(const unsigned int n, const double R, double* x, double* y);
+
+}
\ No newline at end of file
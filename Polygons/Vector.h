@@ -1,48 +1,109 @@
 // Vector.h
 // A class for (2D) vectors; used for storing vertex locations and for translations
+// Everything is defined inline (and constexpr where possible) so the compiler can fully inline the arithmetic
+// into the loops that use it. The class is trivially copyable.
 #pragma once
 
 #include <iostream>
+#include <iomanip>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <type_traits>
+#include "Access.h"
 #include "Matrix.h"
 
 class Vector {
 private:
 	double x, y;
 
+	[[noreturn]] static void outofrange()
+	{
+		std::cerr << "Error: Attempted to access vector element out of range." << std::endl;
+		exit(1);
+	}
+
 public:
-	Vector() : // default ctor
+	constexpr Vector() : // default ctor
 		x(0),
 		y(0)
 	{}
-	Vector(double x, double y) : // parameterised ctor
+	constexpr Vector(double x, double y) : // parameterised ctor
 		x(x),
 		y(y)
 	{}
-	
-	~Vector() {} // destructor
-	
-	Vector(const Vector& param) : // copy ctor
-		x(param.x),
-		y(param.y)
-	{}
 
-	const Vector& operator= (const Vector& rhs);
-	const Vector& operator+= (const Vector& rhs);
-	const Vector& operator-= (const Vector& rhs);
+	const Vector& operator+= (const Vector& rhs) { x += rhs.x; y += rhs.y; return *this; }
+	const Vector& operator-= (const Vector& rhs) { x -= rhs.x; y -= rhs.y; return *this; }
+
+	constexpr const double dot(const Vector& rhs) const { return x*rhs.x + y*rhs.y; } // scalar product
 
-	const double dot(const Vector& rhs) const; // scalar product
+	constexpr const Vector operator+ (const Vector& rhs) const { return Vector(x + rhs.x, y + rhs.y); }
+	constexpr const Vector operator- (const Vector& rhs) const { return Vector(x - rhs.x, y - rhs.y); }
+	constexpr const Vector operator- () const { return Vector(-x, -y); } // inverse vector i.e -(x,y) = (-x,-y)
 
-	const Vector operator+ (const Vector& rhs) const;
-	const Vector operator- (const Vector& rhs) const;
-	const Vector operator- () const; // inverse vector i.e -(x,y) = (-x,-y)
+	// Direct accessors - no range checking needed
+	constexpr const double getx() const { return x; }
+	constexpr const double gety() const { return y; }
 
-	const double& operator() (const int i) const; // element accessor
-	double& operator() (const int i); // overload for non const vectors
+	// Element accessors - 1-based, i.e. i = 1 or 2. Range checked according to Policy (see Access.h); without
+	// the check, any i other than 1 gives y.
+	template<class Policy = access::Default>
+	constexpr const double& at(const int i) const
+	{
+		if constexpr (Policy::checked) { if (i != 1 && i != 2) { outofrange(); } }
+		return (i == 1) ? x : y;
+	}
+	template<class Policy = access::Default>
+	double& at(const int i) // overload for non const vectors
+	{
+		if constexpr (Policy::checked) { if (i != 1 && i != 2) { outofrange(); } }
+		return (i == 1) ? x : y;
+	}
+	constexpr const double& operator() (const int i) const { return at(i); }
+	double& operator() (const int i) { return at(i); }
 };
 
+typedef Vector Vector2;
+static_assert(std::is_trivially_copyable<Vector>::value, "Vector must stay trivially copyable");
+
 // Additional operator overloads:
 // (Note: using non-member non-friend functions for greater encapsulation)
-const Vector operator* (double lhs, const Vector& rhs);
-const Vector operator* (const Matrix& lhs, const Vector& rhs); // Matrix transformation
+constexpr const Vector operator* (double lhs, const Vector& rhs)
+{
+	return Vector(lhs * rhs.getx(), lhs * rhs.gety());
+}
+
+constexpr const Vector operator* (const Matrix& lhs, const Vector& rhs) // Matrix transformation
+{
+	return Vector(lhs(1, 1) * rhs.getx() + lhs(1, 2) * rhs.gety(), lhs(2, 1) * rhs.getx() + lhs(2, 2) * rhs.gety());
+}
+
+inline std::ostream& operator<< (std::ostream& os, const Vector& rhs)
+{
+	os << "(";
+	if (std::fabs(std::fmod(rhs(1), 1.0)) < 0.01 || std::fabs(rhs(1)) < 0.01) { os << std::fixed << std::setprecision(0) << rhs(1); }
+	else { os << std::fixed << std::setprecision(2) << rhs(1); }
+	os << ",";
+	if (std::fabs(std::fmod(rhs(2), 1.0)) < 0.01 || std::fabs(rhs(2)) < 0.01) { os << std::fixed << std::setprecision(0) << rhs(2); }
+	else { os << std::fixed << std::setprecision(2) << rhs(2); }
+	os << ")";
+	return os;
+}
 
-std::ostream& operator<< (std::ostream& os, const Vector& rhs);
\ No newline at end of file
+// Appends the same text as operator<< to out, but without going through a stream (and without changing any
+// stream's formatting flags)
+inline void append(std::string& out, const Vector& rhs)
+{
+	char text[640]; // Room for two of the longest doubles in fixed notation (309 digits plus sign and decimals)
+	char* p{ text };
+	*p++ = '(';
+	const int precisionx{ (std::fabs(std::fmod(rhs(1), 1.0)) < 0.01 || std::fabs(rhs(1)) < 0.01) ? 0 : 2 };
+	p = std::to_chars(p, text + sizeof(text), rhs(1), std::chars_format::fixed, precisionx).ptr;
+	*p++ = ',';
+	const int precisiony{ (std::fabs(std::fmod(rhs(2), 1.0)) < 0.01 || std::fabs(rhs(2)) < 0.01) ? 0 : 2 };
+	p = std::to_chars(p, text + sizeof(text), rhs(2), std::chars_format::fixed, precisiony).ptr;
+	*p++ = ')';
+	out.append(text, p);
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+// VertexStore.cpp
+// Contiguous structure-of-arrays storage for polygon vertices.
+
+#include <iostream>
+#include <new>
+#include "VertexStore.h"
+
+// New spans are always appended to the end of the arrays. Growing the arrays may move them, so polygons
+// hold on to their offset rather than a pointer.
+const std::size_t VertexStore::allocate(const unsigned int n)
+{
+	const std::size_t offset{ xs.size() };
+	try {
+		xs.resize(offset + n, 0.0);
+		ys.resize(offset + n, 0.0);
+		localxs.resize(offset + n, 0.0);
+		localys.resize(offset + n, 0.0);
+	}
+	catch (std::bad_alloc memfail)
+	{
+		std::cerr << "Error: Could not allocate memory for vertices." << std::endl;
+		exit(1);
+	}
+	return offset;
+}
+
+// Released spans are zeroed so that they don't affect scans over the arrays (e.g. the image extent in draw()).
+// If the span is at the end of the arrays it is simply trimmed off, otherwise it is left as a hole.
+void VertexStore::release(const std::size_t offset, const unsigned int n)
+{
+	if (offset + n == xs.size()) {
+		xs.resize(offset);
+		ys.resize(offset);
+		localxs.resize(offset);
+		localys.resize(offset);
+		return;
+	}
+	for (std::size_t i{ offset }; i < offset + n; i++) {
+		xs[i] = 0;
+		ys[i] = 0;
+		localxs[i] = 0;
+		localys[i] = 0;
+	}
+	holes += n;
+	return;
+}
+
+void VertexStore::clear()
+{
+	xs.clear();
+	ys.clear();
+	localxs.clear();
+	localys.clear();
+	holes = 0;
+	return;
+}
+
+void VertexStore::compact(std::vector<std::size_t>& offsets, const std::vector<unsigned int>& counts)
+{
+	std::vector<double> newxs, newys, newlocalxs, newlocalys;
+	const std::size_t total{ xs.size() - holes };
+	try {
+		newxs.reserve(total);
+		newys.reserve(total);
+		newlocalxs.reserve(total);
+		newlocalys.reserve(total);
+	}
+	catch (std::bad_alloc memfail)
+	{
+		std::cerr << "Error: Could not allocate memory for vertices." << std::endl;
+		exit(1);
+	}
+	for (std::size_t k{ 0 }; k < offsets.size(); k++) {
+		const std::size_t from{ offsets[k] }, to{ from + counts[k] };
+		offsets[k] = newxs.size();
+		newxs.insert(newxs.end(), xs.begin() + from, xs.begin() + to);
+		newys.insert(newys.end(), ys.begin() + from, ys.begin() + to);
+		newlocalxs.insert(newlocalxs.end(), localxs.begin() + from, localxs.begin() + to);
+		newlocalys.insert(newlocalys.end(), localys.begin() + from, localys.begin() + to);
+	}
+	xs.swap(newxs);
+	ys.swap(newys);
+	localxs.swap(newlocalxs);
+	localys.swap(newlocalys);
+	holes = 0;
+	return;
+}
+
+void VertexStore::reserve(const std::size_t n)
+{
+	xs.reserve(n);
+	ys.reserve(n);
+	localxs.reserve(n);
+	localys.reserve(n);
+	return;
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+// VertexStore.h
+// Contiguous structure-of-arrays storage for polygon vertices. All the x coords live in one array and all
+// the y coords in another; each polygon is a span (offset, count) into these arrays.
+// There are two sets of arrays: the local (canonical) vertices that a polygon was built with, and the world
+// vertices, which are the local ones with the polygon's accumulated transformation applied (see Polygon.h).
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+class VertexStore {
+private:
+	std::vector<double> xs, ys; // World coords
+	std::vector<double> localxs, localys; // Local coords
+	std::size_t holes; // Number of vertex slots belonging to released spans
+
+public:
+	VertexStore() : holes(0) {}
+	~VertexStore() {}
+
+	const std::size_t allocate(const unsigned int n); // Reserve a span of n vertices - returns its offset
+	void release(const std::size_t offset, const unsigned int n); // Give a span back to the store
+
+	void reserve(const std::size_t n); // Pre-allocate room for n vertices in total
+	void clear(); // Drop every span at once - only once all the polygons using the store are gone
+
+	// Close up the holes. The spans (offsets[k], counts[k]) are laid out again one after another, in order, and
+	// offsets[k] is updated to each span's new position.
+	void compact(std::vector<std::size_t>& offsets, const std::vector<unsigned int>& counts);
+
+	const std::size_t size() const { return xs.size(); } // Total vertex slots, including holes
+	const std::size_t holecount() const { return holes; }
+
+	// Raw array access - spans are addressed relative to these
+	double* x() { return xs.data(); }
+	double* y() { return ys.data(); }
+	const double* x() const { return xs.data(); }
+	const double* y() const { return ys.data(); }
+	double* localx() { return localxs.data(); }
+	double* localy() { return localys.data(); }
+	const double* localx() const { return localxs.data(); }
+	const double* localy() const { return localys.data(); }
+};
\ No newline at end of file
@@ -0,0 +1,170 @@
+// Tests.cpp
+// Regression tests for the polygon manager, as a separate executable.
+
+// Each test is a function that builds what it needs, runs it and checks the results with CHECK, which reports
+// a failure (with its line) and carries on. The program exits with 1 if any check failed, so it can be run by
+// 'make check'. Files the tests write are put in the current directory and removed again.
+//
+// Usage: Tests [--filter <text>]
+//		--filter	Only run the tests whose names contain text
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include "PolygonManager.h"
+#include "Snapshot.h"
+
+namespace {
+
+	std::string filter;
+	unsigned int run{ 0 }, failed{ 0 };
+	bool ok; // Whether the current test has passed so far
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+	void check(const bool condition, const char* const text, const int line)
+	{
+		if (condition) { return; }
+		std::cout << "\tline " << line << ": CHECK(" << text << ") failed" << std::endl;
+		ok = false;
+	}
+
+	template<class Body>
+	void test(const std::string& name, const Body& body)
+	{
+		if (!filter.empty() && name.find(filter) == std::string::npos) { return; }
+		ok = true;
+		body();
+		run++;
+		if (!ok) { failed++; }
+		std::cout << (ok ? "pass " : "FAIL ") << name << std::endl;
+	}
+
+	// Write text to path, replacing what's there
+	void writefile(const char* const path, const char* const text)
+	{
+		std::FILE* const out{ std::fopen(path, "wb") };
+		if (out == nullptr) { return; }
+		std::fwrite(text, 1, std::strlen(text), out);
+		std::fclose(out);
+	}
+
+	// Tests:
+
+	void textiotests()
+	{
+		const char* const path{ "tests.tmp" };
+		PolygonManager pm(1);
+
+		test("textio.wkt", [&] {
+			writefile(path, "POLYGON ((0 0, 4 0, 4 3, 0 0))\nPOLYGON ((1 1, 2 1, 2 2, 1 2))\n");
+			pm.clear();
+			CHECK(pm.importtext(path, PolygonManager::wkt));
+			CHECK(pm.count() == 2);
+			CHECK(pm.getarea(1) == 6);
+		});
+		test("textio.wkt.nonfinite", [&] { // A bad file adds nothing
+			const char* const lines[]{ "POLYGON ((nan 0, 1 0, 0 1, nan 0))\n", "POLYGON ((0 0, inf 0, 0 1))\n",
+				"POLYGON ((0 0, 1 -infinity, 0 1))\n", "POLYGON ((0 0, 1 0, 0 1))\nPOLYGON ((0 0, 1 0, 0 NAN))\n" };
+			for (const char* const text : lines) {
+				writefile(path, text);
+				pm.clear();
+				CHECK(!pm.importtext(path, PolygonManager::wkt));
+				CHECK(pm.count() == 0);
+			}
+		});
+		test("textio.csv", [&] {
+			writefile(path, "id,x,y\na,0,0\na,4,0\na,4,3\nb,1,1\nb,2,1\nb,2,2\n");
+			pm.clear();
+			CHECK(pm.importtext(path, PolygonManager::csv));
+			CHECK(pm.count() == 2);
+			CHECK(pm.getarea(1) == 6);
+		});
+		test("textio.csv.nonfinite", [&] {
+			const char* const lines[]{ "a,nan,0\na,1,0\na,0,1\n", "id,x,y\na,0,0\na,inf,0\na,0,1\n",
+				"a,0,0\na,1,0\na,0,-Infinity\n" };
+			for (const char* const text : lines) {
+				writefile(path, text);
+				pm.clear();
+				CHECK(!pm.importtext(path, PolygonManager::csv));
+				CHECK(pm.count() == 0);
+			}
+		});
+		std::remove(path);
+		return;
+	}
+
+	void snapshottests()
+	{
+		const char* const path{ "tests.tmp" };
+		const double nan{ std::numeric_limits<double>::quiet_NaN() }, inf{ std::numeric_limits<double>::infinity() };
+
+		// Save a small scene, overwrite the double at byte offset 'at' of the file with value, and check that
+		// loading it fails and leaves the scene that was there before
+		const auto corrupt = [&](const auto at, const double value) {
+			PolygonManager pm(1);
+			pm.addrect(2, 3);
+			pm.addngon(7, 1);
+			pm.translate(2, Vector(5, 5));
+			CHECK(pm.save(path));
+			snapshot::Header header;
+			std::FILE* const file{ std::fopen(path, "r+b") };
+			if (file == nullptr || std::fread(&header, sizeof(header), 1, file) != 1) {
+				CHECK(false);
+				if (file) { std::fclose(file); }
+				return;
+			}
+			std::fseek(file, (long)at(header), SEEK_SET);
+			std::fwrite(&value, sizeof(value), 1, file);
+			std::fclose(file);
+
+			pm.addpenta(1); // The scene that load() should leave alone
+			CHECK(!pm.load(path));
+			CHECK(pm.count() == 3);
+			CHECK(pm.getarea(1) == 6);
+		};
+
+		test("snapshot.roundtrip", [&] {
+			PolygonManager pm(1);
+			pm.addrect(2, 3);
+			pm.addngon(7, 1);
+			CHECK(pm.save(path));
+			pm.clear();
+			CHECK(pm.load(path));
+			CHECK(pm.count() == 2);
+			CHECK(pm.getarea(1) == 6);
+		});
+		test("snapshot.nonfinite.vertex", [&] {
+			corrupt([](const snapshot::Header& h) { return h.xoffset + 5 * sizeof(double); }, nan); // Vertex 2 of the 7-gon
+			corrupt([](const snapshot::Header& h) { return h.yoffset; }, -inf);
+		});
+		test("snapshot.nonfinite.pose", [&] {
+			const std::size_t pose{ offsetof(snapshot::Poly, pose) };
+			corrupt([&](const snapshot::Header& h) { return h.polysoffset + pose; }, nan);
+			corrupt([&](const snapshot::Header& h) { return h.polysoffset + sizeof(snapshot::Poly) + pose + 2 * sizeof(double); }, inf);
+		});
+		std::remove(path);
+		return;
+	}
+
+}
+
+int main(int argc, char* argv[])
+{
+	for (int i{ 1 }; i < argc; i++) {
+		if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) { filter = argv[++i]; }
+		else {
+			std::cerr << "Usage: Tests [--filter <text>]" << std::endl;
+			return 1;
+		}
+	}
+
+	textiotests();
+	snapshottests();
+
+	std::cout << run - failed << " of " << run << " tests passed." << std::endl;
+	return failed == 0 ? 0 : 1;
+}
\ No newline at end of file